@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+import argparse
+import subprocess
+
+# Larger than NPART in any build, particle loops stop at the last active particle anyway
+PARTICLE_LIMIT = 1 << 20
+
+
+class Run:
+    def __init__(self, runner, save, seed):
+        self.runner = runner
+        self.save = save
+        self.seed = seed
+
+    def hashes(self, frames, stop_particle=None):
+        command = [self.runner, self.save, str(frames), str(self.seed)]
+        if stop_particle is not None:
+            command.append(str(stop_particle))
+        output = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, check=True,
+                                universal_newlines=True).stdout
+        hashes = []
+        for line in output.splitlines()[1:]:
+            frame, time_us, parts, state_hash = line.split("\t")
+            hashes.append((int(parts), state_hash))
+        return hashes
+
+    def __str__(self):
+        return "%s %s" % (self.runner, self.save)
+
+
+def first_divergent_frame(a, b, frames):
+    hashes_a = a.hashes(frames)
+    hashes_b = b.hashes(frames)
+    for frame, (hash_a, hash_b) in enumerate(zip(hashes_a, hashes_b)):
+        if hash_a != hash_b:
+            return frame
+    return None
+
+
+def first_divergent_particle(a, b, frame):
+    # the state right before particle i is updated in frame, for i in [low, high], matches at
+    # low and doesn't at high; a particle update in between is what makes them diverge
+    def diverged(i):
+        return a.hashes(frame, i)[-1] != b.hashes(frame, i)[-1]
+
+    if diverged(0):
+        return 0
+    low, high = 0, PARTICLE_LIMIT
+    if not diverged(high):
+        return None
+    while high - low > 1:
+        middle = (low + high) // 2
+        if diverged(middle):
+            high = middle
+        else:
+            low = middle
+    return high
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser("runnerbisect.py", description="finds the first frame and particle update at "
+                                                                    "which two runs of the headless runner diverge; "
+                                                                    "the runs may use different builds, saves, or both")
+    parser.add_argument("runner_a", metavar="RUNNER_A")
+    parser.add_argument("save_a", metavar="SAVE_A")
+    parser.add_argument("runner_b", metavar="RUNNER_B")
+    parser.add_argument("save_b", metavar="SAVE_B")
+    parser.add_argument("frames", metavar="FRAMES", type=int)
+    parser.add_argument("seed", metavar="SEED", nargs="?", default=0, type=int, help="Defaults to 0")
+    args = parser.parse_args()
+
+    a = Run(args.runner_a, args.save_a, args.seed)
+    b = Run(args.runner_b, args.save_b, args.seed)
+    frame = first_divergent_frame(a, b, args.frames)
+    if frame is None:
+        print("No divergence in %i frames" % args.frames)
+    elif frame == 0:
+        print("Diverged while loading")
+    else:
+        particle = first_divergent_particle(a, b, frame)
+        if particle is None:
+            print("Diverged in frame %i, after all particles were updated" % frame)
+        elif particle == 0:
+            print("Diverged in frame %i, before any particle was updated" % frame)
+        else:
+            print("Diverged in frame %i, while updating particle #%i" % (frame, particle - 1))
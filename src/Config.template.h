@@ -26,6 +26,7 @@
 #mesondefine X86_SSE
 #mesondefine X86_SSE2
 #mesondefine X86_SSE3
+#mesondefine X86_AVX2
 #mesondefine _64BIT
 #mesondefine SERVER
 #mesondefine STATICSERVER
@@ -107,6 +108,10 @@
 
 #define BRUSH_DIR "Brushes"
 
+#define THUMBNAIL_CACHE_DIR "thumbnails"
+// the least recently used thumbnails are removed past this many
+#define THUMBNAIL_CACHE_MAX 1000
+
 #ifndef M_GRAV
 #define M_GRAV 6.67300e-1
 #endif
@@ -0,0 +1,258 @@
+#include "Config.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include "common/String.h"
+
+#include "client/GameSave.h"
+#include "common/tpt-rand.h"
+#include "graphics/PixelKernels.h"
+#include "simulation/Air.h"
+#include "simulation/Gravity.h"
+#include "simulation/Simulation.h"
+
+
+void EngineProcess() {}
+void ClipboardPush(ByteString) {}
+ByteString ClipboardPull() { return ""; }
+int GetModifiers() { return 0; }
+void SetCursorEnabled(int enabled) {}
+unsigned int GetTicks() { return 0; }
+
+void readFile(ByteString filename, std::vector<char> & storage)
+{
+	std::ifstream fileStream;
+	fileStream.open(filename.c_str(), std::ios::binary);
+	if(fileStream.is_open())
+	{
+		fileStream.seekg(0, std::ios::end);
+		size_t fileSize = fileStream.tellg();
+		fileStream.seekg(0);
+
+		storage.resize(fileSize);
+		fileStream.read(&storage[0], fileSize);
+		fileStream.close();
+	}
+}
+
+// Times loading the save into an empty simulation, both by parsing it as part of the load, as
+// happens when opening a save, and from a save that was parsed beforehand, as happens when
+// pasting a stamp. Runs on a simulation of its own so the hashes printed later are unaffected.
+void benchmarkLoad(const GameSave &gameSave, int repeats)
+{
+	using Clock = std::chrono::steady_clock;
+	auto sim = std::make_unique<Simulation>();
+	GameSave expandedSave(gameSave);
+	expandedSave.Expand();
+	auto parseTime = Clock::duration::zero();
+	auto loadCollapsedTime = Clock::duration::zero();
+	auto loadExpandedTime = Clock::duration::zero();
+	for (int i = 0; i < repeats; i++)
+	{
+		auto start = Clock::now();
+		GameSave parsedSave(gameSave);
+		parsedSave.Expand();
+		parseTime += Clock::now() - start;
+
+		sim->clear_sim();
+		start = Clock::now();
+		sim->Load(&gameSave, true);
+		loadCollapsedTime += Clock::now() - start;
+
+		sim->clear_sim();
+		start = Clock::now();
+		sim->Load(&expandedSave, true);
+		loadExpandedTime += Clock::now() - start;
+	}
+	auto averageUs = [repeats](Clock::duration total) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(total).count() / repeats;
+	};
+	std::cerr << "parse " << averageUs(parseTime) << " us, load with parse " << averageUs(loadCollapsedTime)
+	          << " us, load parsed " << averageUs(loadExpandedTime) << " us (" << expandedSave.particlesCount << " particles, average of "
+	          << repeats << ")" << std::endl;
+}
+
+// Runs the pixel kernels the build uses and their plain versions on the same random pixels and
+// counts the runs where the results differ, which should never happen
+int checkKernels()
+{
+	RNG rng;
+	rng.seed(1);
+	int mismatches = 0;
+	const int size = CELL*3*64;
+	std::vector<pixel> original(size), expected(size), actual(size);
+	auto randomise = [&rng, &original, &expected, &actual]() {
+		for (auto &p : original)
+			p = pixel(rng.gen());
+		expected = original;
+		actual = original;
+	};
+	for (int run = 0; run < 10000; run++)
+	{
+		// unaligned starts and counts that leave a tail after the vectorised part
+		int offset = rng.between(0, 7);
+		int count = rng.between(0, size - 8);
+		int r = rng.between(0, 255), g = rng.between(0, 255), b = rng.between(0, 255);
+		int a = rng.chance(1, 10) ? 255 : rng.between(0, 255);
+
+		randomise();
+		PixelKernels::FadePlain(&original[offset], &expected[offset], count);
+		PixelKernels::Fade(&original[offset], &actual[offset], count);
+		mismatches += expected != actual;
+
+		randomise();
+		PixelKernels::BlendPlain(&expected[offset], count, r, g, b, a);
+		PixelKernels::Blend(&actual[offset], count, r, g, b, a);
+		mismatches += expected != actual;
+
+		unsigned int alpha[CELL*3][CELL*3];
+		// fire intensities only take the alphas past 255 when set from Lua, cover those less often
+		int maxAlpha = rng.chance(1, 4) ? 0x7FFF : 255;
+		for (auto &row : alpha)
+			for (auto &value : row)
+				value = rng.between(0, maxAlpha);
+		bool halveAlpha = rng.chance(1, 2);
+		int stride = CELL*3 + rng.between(0, 40);
+		randomise();
+		PixelKernels::AddFireSplatPlain(&expected[offset], stride, r, g, b, alpha, halveAlpha);
+		PixelKernels::AddFireSplat(&actual[offset], stride, r, g, b, alpha, halveAlpha);
+		mismatches += expected != actual;
+	}
+	std::cout << PixelKernels::Name() << " pixel kernels: " << mismatches << " mismatches" << std::endl;
+	return mismatches ? 1 : 0;
+}
+
+#ifdef main
+# undef main // thank you sdl
+#endif
+
+int main(int argc, char *argv[])
+{
+	auto *program = argv[0];
+	// options go before the other arguments
+	bool skipSettled = false;
+	int loadRepeats = 0;
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (ByteString(argv[1]) == "--skip-settled")
+		{
+			skipSettled = true;
+		}
+		else if (ByteString(argv[1]) == "--check-kernels")
+		{
+			return checkKernels();
+		}
+		else if (ByteString(argv[1]).BeginsWith("--benchmark-load="))
+		{
+			loadRepeats = atoi(argv[1] + 17);
+			if (loadRepeats < 1)
+			{
+				std::cerr << "Invalid repeat count " << argv[1] + 17 << std::endl;
+				return 1;
+			}
+		}
+		else
+		{
+			std::cerr << "Unknown option " << argv[1] << std::endl;
+			return 1;
+		}
+		argv++;
+		argc--;
+	}
+	if (argc < 3)
+	{
+		std::cout << "Usage: " << program << " [--skip-settled] [--benchmark-load=<repeats>] <inputFilename> <frames> [seed [stopParticle]]" << std::endl;
+		std::cout << "       " << program << " --check-kernels" << std::endl;
+		return 1;
+	}
+	ByteString inputFilename = argv[1];
+	int frames = atoi(argv[2]);
+	unsigned int seed = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 0) : 0U;
+	// stop the last frame right before updating this particle, so runs can be compared mid-frame
+	int stopParticle = argc > 4 ? atoi(argv[4]) : -1;
+
+	std::vector<char> inputFile;
+	readFile(inputFilename, inputFile);
+	if (!inputFile.size())
+	{
+		std::cerr << "Could not read " << inputFilename << std::endl;
+		return 1;
+	}
+
+	std::unique_ptr<GameSave> gameSave;
+	try
+	{
+		gameSave = std::make_unique<GameSave>(inputFile);
+	}
+	catch (ParseException &e)
+	{
+		std::cerr << "Could not load " << inputFilename << ": " << e.what() << std::endl;
+		return 1;
+	}
+
+	if (loadRepeats)
+		benchmarkLoad(*gameSave, loadRepeats);
+
+	auto sim = std::make_unique<Simulation>();
+	sim->gravityMode = gameSave->gravityMode;
+	sim->air->airMode = gameSave->airMode;
+	sim->air->ambientAirTemp = gameSave->ambientAirTemp;
+	sim->edgeMode = gameSave->edgeMode;
+	sim->legacy_enable = gameSave->legacyEnable;
+	sim->water_equal_test = gameSave->waterEEnabled;
+	sim->aheat_enable = gameSave->aheatEnable;
+	sim->skipSettledParticles = skipSettled;
+	if (gameSave->gravityEnable)
+	{
+		// gravity is computed on its own thread, so results are only reproducible without it
+		std::cerr << "Warning: save has Newtonian gravity enabled, hashes may not be reproducible" << std::endl;
+		sim->grav->start_grav_async();
+	}
+	// loading already draws random numbers (for insulator air blocking), so seed first;
+	// saves then carry their own generator state, which an explicit seed overrides
+	sim->rng.seed(seed);
+	if (sim->Load(gameSave.get(), true))
+	{
+		std::cerr << "Could not load " << inputFilename << " into the simulation" << std::endl;
+		return 1;
+	}
+	if (argc > 3)
+		sim->rng.seed(seed);
+
+	std::cout << "frame\ttime_us\tparts\thash" << std::endl;
+	std::cout << 0 << "\t" << 0 << "\t" << sim->NUM_PARTS << "\t" << std::hex << std::setw(16) << std::setfill('0') << sim->StateHash() << std::dec << std::endl;
+
+	using Clock = std::chrono::steady_clock;
+	auto totalTime = Clock::duration::zero();
+	for (int frame = 1; frame <= frames; frame++)
+	{
+		auto start = Clock::now();
+		sim->BeforeSim();
+		if (frame == frames && stopParticle >= 0)
+		{
+			sim->UpdateParticles(0, stopParticle - 1);
+		}
+		else
+		{
+			sim->UpdateParticles(0, NPART);
+			sim->AfterSim();
+		}
+		auto elapsed = Clock::now() - start;
+		totalTime += elapsed;
+
+		auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+		std::cout << frame << "\t" << elapsedUs << "\t" << sim->NUM_PARTS << "\t" << std::hex << std::setw(16) << std::setfill('0') << sim->StateHash() << std::dec << std::endl;
+	}
+
+	auto totalUs = std::chrono::duration_cast<std::chrono::microseconds>(totalTime).count();
+	std::cerr << frames << " frames in " << totalUs << " us";
+	if (totalUs)
+		std::cerr << " (" << (frames * 1000000.0 / totalUs) << " fps)";
+	std::cerr << std::endl;
+	return 0;
+}
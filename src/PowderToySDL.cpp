@@ -2,6 +2,7 @@
 #include "common/tpt-minmax.h"
 
 #include <map>
+#include <vector>
 #include <ctime>
 #include <climits>
 #ifdef WIN
@@ -40,6 +41,7 @@
 #include "Misc.h"
 
 #include "client/Client.h"
+#include "client/ImageWriter.h"
 #include "client/GameSave.h"
 #include "client/SaveFile.h"
 #include "client/SaveInfo.h"
@@ -166,9 +168,26 @@ void blit()
 	SDL_GL_SwapWindow(sdl_window);
 }
 #else
+// what was last uploaded to sdl_texture, empty if its contents are unknown
+std::vector<pixel> uploadedVid;
+
 void blit(pixel * vid)
 {
-	SDL_UpdateTexture(sdl_texture, NULL, vid, WINDOWW * sizeof (Uint32));
+	// only upload the rows that changed, which is often none with the renderer keeping frames
+	int top = 0, bottom = WINDOWH;
+	if (uploadedVid.size())
+	{
+		while (top < bottom && std::equal(vid + top * WINDOWW, vid + (top + 1) * WINDOWW, &uploadedVid[top * WINDOWW]))
+			top++;
+		while (bottom > top && std::equal(vid + (bottom - 1) * WINDOWW, vid + bottom * WINDOWW, &uploadedVid[(bottom - 1) * WINDOWW]))
+			bottom--;
+	}
+	if (top < bottom)
+	{
+		SDL_Rect rect = { 0, top, WINDOWW, bottom - top };
+		SDL_UpdateTexture(sdl_texture, &rect, vid + top * WINDOWW, WINDOWW * sizeof (Uint32));
+		uploadedVid.assign(vid, vid + WINDOWW * WINDOWH);
+	}
 	// need to clear the renderer if there are black edges (fullscreen, or resizable window)
 	if (fullscreen || resizable)
 		SDL_RenderClear(sdl_renderer);
@@ -296,6 +315,9 @@ bool RecreateWindow()
 	if (forceIntegerScaling && fullscreen)
 		SDL_RenderSetIntegerScale(sdl_renderer, SDL_TRUE);
 	sdl_texture = SDL_CreateTexture(sdl_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, WINDOWW, WINDOWH);
+#ifndef OGLI
+	uploadedVid.clear();
+#endif
 	SDL_RaiseWindow(sdl_window);
 	//Uncomment this to enable resizing
 	//SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
@@ -498,6 +520,13 @@ void EventProcess(SDL_Event event)
 		SDL_CaptureMouse(SDL_FALSE);
 #endif
 		break;
+#ifndef OGLI
+	case SDL_RENDER_TARGETS_RESET:
+	case SDL_RENDER_DEVICE_RESET:
+		// the texture may have lost what blit uploaded to it
+		uploadedVid.clear();
+		break;
+#endif
 	case SDL_WINDOWEVENT:
 	{
 		switch (event.window.event)
@@ -1011,6 +1040,8 @@ int main(int argc, char * argv[])
 	ui::Engine::Ref().CloseWindow();
 	delete gameController;
 	delete ui::Engine::Ref().g;
+	// screenshots taken right before quitting may still be being written
+	ImageWriter::Ref().Flush();
 	Client::Ref().Shutdown();
 	if (SDL_GetWindowFlags(sdl_window) & SDL_WINDOW_OPENGL)
 	{
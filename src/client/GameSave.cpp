@@ -32,6 +32,8 @@ GameSave::GameSave(const GameSave & save):
 	signs(save.signs),
 	stkm(save.stkm),
 	palette(save.palette),
+	hasRngState(save.hasRngState),
+	rngState(save.rngState),
 	pmapbits(save.pmapbits),
 	expanded(save.expanded),
 	hasOriginalData(save.hasOriginalData),
@@ -44,7 +46,8 @@ GameSave::GameSave(const GameSave & save):
 	{
 		setSize(save.blockWidth, save.blockHeight);
 
-		std::copy(save.particles, save.particles+NPART, particles);
+		// nothing past particlesCount is ever read
+		std::copy(save.particles, save.particles+save.particlesCount, particles);
 		for (int j = 0; j < blockHeight; j++)
 		{
 			std::copy(save.blockMap[j], save.blockMap[j]+blockWidth, blockMap[j]);
@@ -179,9 +182,11 @@ void GameSave::InitVars()
 	edgeMode = 0;
 	translated.x = translated.y = 0;
 	pmapbits = 8; // default to 8 bits for older saves
+	hasRngState = false;
+	rngState = RNG::State();
 }
 
-bool GameSave::Collapsed()
+bool GameSave::Collapsed() const
 {
 	return !expanded;
 }
@@ -606,9 +611,9 @@ void GameSave::CheckBsonFieldFloat(bson_iterator iter, const char *field, float
 void GameSave::readOPS(char * data, int dataLength)
 {
 	unsigned char *inputData = (unsigned char*)data, *bsonData = NULL, *partsData = NULL, *partsPosData = NULL, *fanData = NULL, *wallData = NULL, *soapLinkData = NULL;
-	unsigned char *pressData = NULL, *vxData = NULL, *vyData = NULL, *ambientData = NULL;
+	unsigned char *pressData = NULL, *vxData = NULL, *vyData = NULL, *ambientData = NULL, *rngStateData = NULL;
 	unsigned int inputDataLen = dataLength, bsonDataLen = 0, partsDataLen, partsPosDataLen, fanDataLen, wallDataLen, soapLinkDataLen;
-	unsigned int pressDataLen, vxDataLen, vyDataLen, ambientDataLen;
+	unsigned int pressDataLen, vxDataLen, vyDataLen, ambientDataLen, rngStateDataLen;
 	unsigned partsCount = 0;
 	unsigned int blockX, blockY, blockW, blockH, fullX, fullY, fullW, fullH;
 	int savedVersion = inputData[4];
@@ -693,6 +698,7 @@ void GameSave::readOPS(char * data, int dataLength)
 		CheckBsonFieldUser(iter, "ambientMap", &ambientData, &ambientDataLen);
 		CheckBsonFieldUser(iter, "fanMap", &fanData, &fanDataLen);
 		CheckBsonFieldUser(iter, "soapLinks", &soapLinkData, &soapLinkDataLen);
+		CheckBsonFieldUser(iter, "rngState", &rngStateData, &rngStateDataLen);
 		CheckBsonFieldBool(iter, "legacyEnable", &legacyEnable);
 		CheckBsonFieldBool(iter, "gravityEnable", &gravityEnable);
 		CheckBsonFieldBool(iter, "aheat_enable", &aheatEnable);
@@ -1392,6 +1398,12 @@ void GameSave::readOPS(char * data, int dataLength)
 			throw ParseException(ParseException::Corrupt, "Didn't reach end of particle data buffer");
 	}
 
+	if (rngStateData && rngStateDataLen == sizeof(rngState))
+	{
+		std::copy(rngStateData, rngStateData + sizeof(rngState), reinterpret_cast<unsigned char *>(&rngState[0]));
+		hasRngState = true;
+	}
+
 	if (soapLinkData)
 	{
 		unsigned int soapLinkDataPos = 0;
@@ -2683,6 +2695,8 @@ char * GameSave::serialiseOPS(unsigned int & dataLength)
 		bson_append_binary(&b, "ambientMap", (char)BSON_BIN_USER, (const char*)ambientData.get(), ambientDataLen);
 	if (soapLinkData && soapLinkDataLen)
 		bson_append_binary(&b, "soapLinks", (char)BSON_BIN_USER, (const char *)soapLinkData, soapLinkDataLen);
+	if (hasRngState)
+		bson_append_binary(&b, "rngState", (char)BSON_BIN_USER, (const char *)&rngState[0], sizeof(rngState));
 	unsigned int signsCount = 0;
 	for (size_t i = 0; i < signs.size(); i++)
 	{
@@ -4,6 +4,7 @@
 
 #include <vector>
 #include "common/String.h"
+#include "common/tpt-rand.h"
 #include "Misc.h"
 
 #include "bson/BSON.h"
@@ -110,6 +111,10 @@ public:
 	// author information
 	Json::Value authors;
 
+	// state of the simulation's random number generator, absent from older saves
+	bool hasRngState;
+	RNG::State rngState;
+
 	int pmapbits;
 
 	GameSave();
@@ -128,7 +133,10 @@ public:
 
 	void Expand();
 	void Collapse();
-	bool Collapsed();
+	bool Collapsed() const;
+	// A collapsed save read from data is exactly that data, it can't have been changed since
+	bool HasUnchangedOriginalData() const { return hasOriginalData && !expanded; }
+	const std::vector<char> &GetOriginalData() const { return originalData; }
 
 	static bool TypeInCtype(int type, int ctype);
 	static bool TypeInTmp(int type);
@@ -0,0 +1,79 @@
+#include "ImageWriter.h"
+
+#include "Client.h"
+#include "Format.h"
+#include "graphics/Graphics.h"
+
+#include <algorithm>
+#include <iostream>
+
+ImageWriter::ImageWriter()
+{
+	// encoding is the slow part, but a few threads are enough to keep up with anything
+	// that is drawn on one
+	int threadCount = std::max(std::min(int(std::thread::hardware_concurrency()) - 1, 4), 1);
+	for (int i = 0; i < threadCount; i++)
+		workers.emplace_back(&ImageWriter::Worker, this);
+}
+
+ImageWriter::~ImageWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	queueChanged.notify_all();
+	for (auto &worker : workers)
+		worker.join();
+}
+
+void ImageWriter::Add(std::unique_ptr<VideoBuffer> image, ImageFormat format, ByteString filename)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	queueChanged.wait(lock, [this] { return queue.size() < MaxQueuedImages; });
+	queue.push_back(Job{ std::move(image), format, filename });
+	queueChanged.notify_all();
+}
+
+void ImageWriter::Flush()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	queueChanged.wait(lock, [this] { return queue.empty() && !busyWorkers; });
+}
+
+void ImageWriter::Worker()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		// workers only quit once the queue is empty, so nothing added is lost
+		queueChanged.wait(lock, [this] { return quit || !queue.empty(); });
+		if (queue.empty())
+			return;
+		auto job = std::move(queue.front());
+		queue.pop_front();
+		busyWorkers++;
+		queueChanged.notify_all();
+		lock.unlock();
+
+		std::vector<char> data;
+		switch (job.format)
+		{
+		case PNG:
+			data = format::VideoBufferToPNG(*job.image);
+			break;
+		case PPM:
+			data = format::VideoBufferToPPM(*job.image);
+			break;
+		case BMP:
+			data = format::VideoBufferToBMP(*job.image);
+			break;
+		}
+		if (Client::Ref().WriteFile(data, job.filename))
+			std::cerr << "ImageWriter: could not write " << job.filename << std::endl;
+
+		lock.lock();
+		busyWorkers--;
+		queueChanged.notify_all();
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef IMAGEWRITER_H
+#define IMAGEWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/Singleton.h"
+#include "common/String.h"
+
+class VideoBuffer;
+
+// Encodes images and writes them to files on a few threads of its own, so that taking a
+// screenshot doesn't hold up drawing. Add only blocks while MaxQueuedImages images are
+// waiting to be encoded; Flush waits until everything added so far has been written, and
+// so does destruction.
+class ImageWriter : public Singleton<ImageWriter>
+{
+public:
+	enum ImageFormat
+	{
+		PNG,
+		PPM,
+		BMP,
+	};
+
+private:
+	static constexpr size_t MaxQueuedImages = 16;
+
+	struct Job
+	{
+		std::unique_ptr<VideoBuffer> image;
+		ImageFormat format;
+		ByteString filename;
+	};
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable queueChanged;
+	std::deque<Job> queue;
+	int busyWorkers = 0;
+	bool quit = false;
+
+	void Worker();
+
+public:
+	ImageWriter();
+	~ImageWriter();
+
+	void Add(std::unique_ptr<VideoBuffer> image, ImageFormat format, ByteString filename);
+	void Flush();
+};
+
+#endif // IMAGEWRITER_H
@@ -1,10 +1,17 @@
 #include "ThumbnailRendererTask.h"
 
 #include <cmath>
+#include <list>
+#include <map>
+#include <mutex>
 
+#include "Format.h"
 #include "graphics/Graphics.h"
 #include "simulation/SaveRenderer.h"
+#include "client/Client.h"
 #include "client/GameSave.h"
+#include "client/MD5.h"
+#include "common/Platform.h"
 
 ThumbnailRendererTask::ThumbnailRendererTask(GameSave *save, int width, int height, bool autoRescale, bool decorations, bool fire) :
 	Save(new GameSave(*save)),
@@ -20,8 +27,73 @@ ThumbnailRendererTask::~ThumbnailRendererTask()
 {
 }
 
+// Thumbnails of saves read from files (local saves and stamps) are cached on disk, named
+// after a hash of the save data and everything else that changes what they look like
+ByteString ThumbnailRendererTask::CacheFilename() const
+{
+	if (!Save->HasUnchangedOriginalData())
+		return "";
+	auto &data = Save->GetOriginalData();
+	char hash[33];
+	md5_ascii(hash, reinterpret_cast<const unsigned char *>(data.data()), data.size());
+	return ByteString::Build(THUMBNAIL_CACHE_DIR, PATH_SEP, hash, "_", SAVE_VERSION, ".", MINOR_VERSION, ".", BUILD_NUM, "_", Width, "x", Height,
+	                         AutoRescale ? "r" : "", Decorations ? "d" : "", Fire ? "f" : "", ".pti");
+}
+
+// The files in THUMBNAIL_CACHE_DIR from least to most recently used. Files left from earlier runs
+// are listed first, in no particular order, the first time the cache is used.
+static std::mutex cacheMutex;
+static bool cacheListed = false;
+static std::list<ByteString> cacheOrder;
+static std::map<ByteString, std::list<ByteString>::iterator> cacheEntries;
+
+// Marks a cache file as just used, then removes the least recently used ones past THUMBNAIL_CACHE_MAX
+static void UseCacheFile(ByteString filename)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	if (!cacheListed)
+	{
+		for (auto &name : Platform::DirectorySearch(THUMBNAIL_CACHE_DIR, "", { ".pti" }))
+		{
+			ByteString path = ByteString::Build(THUMBNAIL_CACHE_DIR, PATH_SEP, name);
+			if (cacheEntries.find(path) == cacheEntries.end())
+				cacheEntries[path] = cacheOrder.insert(cacheOrder.end(), path);
+		}
+		cacheListed = true;
+	}
+	auto entry = cacheEntries.find(filename);
+	if (entry != cacheEntries.end())
+		cacheOrder.splice(cacheOrder.end(), cacheOrder, entry->second);
+	else
+		cacheEntries[filename] = cacheOrder.insert(cacheOrder.end(), filename);
+	while (cacheOrder.size() > THUMBNAIL_CACHE_MAX)
+	{
+		Platform::RemoveFile(cacheOrder.front());
+		cacheEntries.erase(cacheOrder.front());
+		cacheOrder.pop_front();
+	}
+}
+
 bool ThumbnailRendererTask::doWork()
 {
+	ByteString cacheFilename = CacheFilename();
+	if (cacheFilename.size())
+	{
+		auto cached = Client::Ref().ReadFile(cacheFilename);
+		if (cached.size())
+		{
+			std::vector<char> data(cached.begin(), cached.end());
+			thumbnail = std::unique_ptr<VideoBuffer>(format::PTIToVideoBuffer(data));
+			if (thumbnail)
+			{
+				UseCacheFile(cacheFilename);
+				Width = thumbnail->Width;
+				Height = thumbnail->Height;
+				return true;
+			}
+		}
+	}
+
 	thumbnail = std::unique_ptr<VideoBuffer>(SaveRenderer::Ref().Render(Save.get(), Decorations, Fire));
 	if (thumbnail)
 	{
@@ -39,6 +111,12 @@ bool ThumbnailRendererTask::doWork()
 		{
 			thumbnail->Resize(Width, Height, true);
 		}
+		if (cacheFilename.size())
+		{
+			Platform::MakeDirectory(THUMBNAIL_CACHE_DIR);
+			if (!Client::Ref().WriteFile(format::VideoBufferToPTI(*thumbnail), cacheFilename))
+				UseCacheFile(cacheFilename);
+		}
 		return true;
 	}
 	else
@@ -2,6 +2,7 @@
 #define THUMBNAILRENDERER_H
 
 #include "tasks/AbandonableTask.h"
+#include "common/String.h"
 
 #include <memory>
 
@@ -16,6 +17,8 @@ class ThumbnailRendererTask : public AbandonableTask
 	bool AutoRescale;
 	std::unique_ptr<VideoBuffer> thumbnail;
 
+	ByteString CacheFilename() const;
+
 public:
 	ThumbnailRendererTask(GameSave *save, int width, int height, bool autoRescale = false, bool decorations = true, bool fire = true);
 	virtual ~ThumbnailRendererTask();
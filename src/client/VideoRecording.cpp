@@ -0,0 +1,204 @@
+#include "VideoRecording.h"
+
+#include "graphics/Graphics.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+static const char recordingMagic[8] = { 'T', 'P', 'T', 'R', 'E', 'C', 1, 0 };
+// larger than any frame this could record, anything beyond is a damaged file
+static const int maxFrameSide = 1 << 14;
+
+static void PutU32(std::ostream &stream, uint32_t value)
+{
+	unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+	stream.write(reinterpret_cast<char *>(bytes), 4);
+}
+
+static bool GetU32(std::istream &stream, uint32_t &value)
+{
+	unsigned char bytes[4];
+	if (!stream.read(reinterpret_cast<char *>(bytes), 4))
+		return false;
+	value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t(bytes[3]) << 24);
+	return true;
+}
+
+VideoRecordingWriter::VideoRecordingWriter(ByteString path, int width, int height) :
+	file(path.c_str(), std::ios::binary),
+	width(width),
+	height(height)
+{
+	if (!file)
+		throw std::runtime_error(ByteString::Build("could not create ", path));
+	file.write(recordingMagic, sizeof(recordingMagic));
+	PutU32(file, width);
+	PutU32(file, height);
+	thread = std::thread([this]() {
+		Write();
+	});
+}
+
+VideoRecordingWriter::~VideoRecordingWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	queueChanged.notify_all();
+	thread.join();
+}
+
+void VideoRecordingWriter::AddFrame(const VideoBuffer &frame)
+{
+	if (frame.Width != width || frame.Height != height)
+		return;
+	std::unique_lock<std::mutex> lock(mutex);
+	queueChanged.wait(lock, [this]() {
+		return queue.size() < MaxQueuedFrames || failed;
+	});
+	if (failed)
+		return;
+	queue.emplace_back(frame.Buffer, frame.Buffer + width * height);
+	queueChanged.notify_all();
+}
+
+bool VideoRecordingWriter::Failed()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return failed;
+}
+
+void VideoRecordingWriter::Write()
+{
+	std::vector<unsigned char> previous(width * height * 3);
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		queueChanged.wait(lock, [this]() {
+			return quit || !queue.empty();
+		});
+		if (queue.empty())
+			break;
+		auto frame = std::move(queue.front());
+		queue.pop_front();
+		queueChanged.notify_all();
+		lock.unlock();
+		bool written = WriteFrame(frame, previous);
+		lock.lock();
+		if (!written)
+		{
+			// wake up AddFrame if it's waiting for space, it drops frames from now on
+			failed = true;
+			queue.clear();
+			queueChanged.notify_all();
+		}
+	}
+	file.close();
+}
+
+bool VideoRecordingWriter::WriteFrame(const std::vector<pixel> &frame, std::vector<unsigned char> &previous)
+{
+	bool key = framesWritten % KeyFrameInterval == 0;
+	std::vector<unsigned char> bytes(previous.size());
+	for (size_t i = 0; i < frame.size(); i++)
+	{
+		unsigned char rgb[3] = { (unsigned char)PIXR(frame[i]), (unsigned char)PIXG(frame[i]), (unsigned char)PIXB(frame[i]) };
+		for (int c = 0; c < 3; c++)
+		{
+			// mostly zeroes when little changes between frames, which zlib compresses well
+			bytes[i * 3 + c] = key ? rgb[c] : (rgb[c] ^ previous[i * 3 + c]);
+			previous[i * 3 + c] = rgb[c];
+		}
+	}
+	auto compressedSize = compressBound(uLong(bytes.size()));
+	std::vector<unsigned char> compressed(compressedSize);
+	if (compress2(compressed.data(), &compressedSize, bytes.data(), uLong(bytes.size()), Z_BEST_SPEED) != Z_OK)
+		return false;
+	file.put(key ? 1 : 0);
+	PutU32(file, uint32_t(compressedSize));
+	file.write(reinterpret_cast<char *>(compressed.data()), compressedSize);
+	framesWritten++;
+	return bool(file);
+}
+
+VideoRecordingReader::VideoRecordingReader(ByteString path) :
+	file(path.c_str(), std::ios::binary)
+{
+	char magic[sizeof(recordingMagic)];
+	uint32_t fileWidth, fileHeight;
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, recordingMagic, sizeof(magic)) || !GetU32(file, fileWidth) || !GetU32(file, fileHeight)
+	        || !fileWidth || !fileHeight || fileWidth > maxFrameSide || fileHeight > maxFrameSide)
+		throw std::runtime_error(ByteString::Build("could not open ", path, " as a recording"));
+	width = fileWidth;
+	height = fileHeight;
+
+	auto position = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff fileSize = file.tellg();
+	file.seekg(position);
+	while (true)
+	{
+		auto offset = file.tellg();
+		char key;
+		uint32_t compressedSize;
+		if (!file.get(key) || !GetU32(file, compressedSize) || std::streamoff(file.tellg()) + compressedSize > fileSize)
+			break;
+		// a delta needs a frame to apply to
+		if (frameOffsets.empty() && !key)
+			throw std::runtime_error(ByteString::Build(path, " does not start with a key frame"));
+		frameOffsets.push_back(offset);
+		keyFrames.push_back(key);
+		file.seekg(compressedSize, std::ios::cur);
+	}
+	file.clear();
+}
+
+void VideoRecordingReader::DecodeFrame(int index)
+{
+	int start = index;
+	while (!keyFrames[start])
+		start--;
+	if (decodedIndex >= start && decodedIndex < index)
+		start = decodedIndex + 1;
+	else
+		decoded.assign(width * height * 3, 0);
+	std::vector<unsigned char> compressed, bytes(decoded.size());
+	for (int frame = start; frame <= index; frame++)
+	{
+		// invalidate the cache first in case this throws halfway through
+		decodedIndex = -1;
+		char key;
+		uint32_t compressedSize;
+		file.seekg(frameOffsets[frame]);
+		file.get(key);
+		GetU32(file, compressedSize);
+		compressed.resize(compressedSize);
+		file.read(reinterpret_cast<char *>(compressed.data()), compressedSize);
+		auto size = uLongf(bytes.size());
+		if (!file || uncompress(bytes.data(), &size, compressed.data(), compressedSize) != Z_OK || size != bytes.size())
+		{
+			file.clear();
+			throw std::runtime_error(ByteString::Build("frame ", frame, " is damaged"));
+		}
+		if (key)
+			decoded.swap(bytes);
+		else
+			for (size_t i = 0; i < decoded.size(); i++)
+				decoded[i] ^= bytes[i];
+		decodedIndex = frame;
+	}
+}
+
+VideoBuffer VideoRecordingReader::Frame(int index)
+{
+	if (index < 0 || index >= FrameCount())
+		throw std::runtime_error(ByteString::Build("no frame ", index));
+	if (decodedIndex != index)
+		DecodeFrame(index);
+	VideoBuffer frame(width, height);
+	for (int i = 0; i < width * height; i++)
+		frame.Buffer[i] = PIXRGB(decoded[i * 3], decoded[i * 3 + 1], decoded[i * 3 + 2]);
+	return frame;
+}
@@ -0,0 +1,82 @@
+#ifndef VIDEORECORDING_H
+#define VIDEORECORDING_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/String.h"
+#include "graphics/Pixel.h"
+
+class VideoBuffer;
+
+// A recording is a single file of frames, each stored as the zlib compressed RGB bytes
+// of the frame, XORed with the previous frame unless it is a key frame:
+//   "TPTREC\x01\x00" width:u32 height:u32
+//   then per frame: key:u8 compressedSize:u32 compressed bytes
+// all little endian. Every KeyFrameInterval-th frame is a key frame. There is no index at
+// the end, so a recording cut short by a crash can still be read up to its last complete
+// frame.
+
+// Appends frames to a recording from a thread of its own, so the thread drawing the
+// frames only has to copy them. AddFrame only blocks if the writer falls MaxQueuedFrames
+// frames behind.
+class VideoRecordingWriter
+{
+	static constexpr int KeyFrameInterval = 60;
+	static constexpr size_t MaxQueuedFrames = 32;
+
+	std::ofstream file;
+	int width, height;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable queueChanged;
+	std::deque<std::vector<pixel>> queue;
+	bool quit = false;
+	bool failed = false;
+	int framesWritten = 0;
+
+	void Write();
+	bool WriteFrame(const std::vector<pixel> &frame, std::vector<unsigned char> &previous);
+
+public:
+	// throws std::runtime_error if the file can't be created
+	VideoRecordingWriter(ByteString path, int width, int height);
+	// writes whatever frames are still queued before returning
+	~VideoRecordingWriter();
+
+	// frames of a size other than the one the recording was started with are ignored
+	void AddFrame(const VideoBuffer &frame);
+	// true once writing to the file failed, everything added after that is dropped
+	bool Failed();
+};
+
+// Reconstructs any frame of a recording by decoding forward from the key frame before it.
+class VideoRecordingReader
+{
+	std::ifstream file;
+	int width, height;
+	std::vector<std::streamoff> frameOffsets;
+	std::vector<bool> keyFrames;
+	// the last frame decoded, to make reading frames in order cheap
+	int decodedIndex = -1;
+	std::vector<unsigned char> decoded;
+
+	void DecodeFrame(int index);
+
+public:
+	// throws std::runtime_error if the file can't be opened or isn't a recording
+	VideoRecordingReader(ByteString path);
+
+	int Width() const { return width; }
+	int Height() const { return height; }
+	int FrameCount() const { return int(frameOffsets.size()); }
+	// throws std::runtime_error if the frame is damaged
+	VideoBuffer Frame(int index);
+};
+
+#endif // VIDEORECORDING_H
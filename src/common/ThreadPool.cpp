@@ -0,0 +1,80 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool():
+	nextChunk(0)
+{
+	int threadCount = std::min(int(std::thread::hardware_concurrency()), 16);
+	for (int i = 1; i < threadCount; i++)
+		workers.emplace_back(&ThreadPool::Worker, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_all();
+	for (auto &worker : workers)
+		worker.join();
+}
+
+void ThreadPool::Worker()
+{
+	unsigned int seenGeneration = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		wake.wait(lock, [this, seenGeneration] { return quit || generation != seenGeneration; });
+		if (quit)
+			return;
+		seenGeneration = generation;
+		lock.unlock();
+		RunChunks();
+		lock.lock();
+		if (!--busyWorkers)
+			done.notify_one();
+	}
+}
+
+void ThreadPool::RunChunks()
+{
+	while (true)
+	{
+		int chunkBegin = jobBegin + (nextChunk++) * jobGrain;
+		if (chunkBegin >= jobEnd)
+			break;
+		job(chunkBegin, std::min(chunkBegin + jobGrain, jobEnd));
+	}
+}
+
+void ThreadPool::ParallelFor(int begin, int end, int grain, std::function<void (int, int)> func)
+{
+	if (end <= begin)
+		return;
+	grain = std::max(grain, 1);
+	if (workers.empty() || end - begin <= grain)
+	{
+		func(begin, end);
+		return;
+	}
+
+	std::lock_guard<std::mutex> callLock(callMutex);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = std::move(func);
+		jobBegin = begin;
+		jobEnd = end;
+		jobGrain = grain;
+		nextChunk = 0;
+		busyWorkers = int(workers.size());
+		generation++;
+	}
+	wake.notify_all();
+	RunChunks();
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return !busyWorkers; });
+	job = nullptr;
+}
@@ -0,0 +1,47 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/Singleton.h"
+
+// A fixed set of worker threads that split ranges of independent work items
+// (rows of the air grid, for example) between themselves. The calling thread
+// takes part in the work too, so on a single core machine everything simply
+// runs inline. Jobs must not call ParallelFor themselves.
+class ThreadPool : public Singleton<ThreadPool>
+{
+	std::vector<std::thread> workers;
+	std::mutex callMutex;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::function<void (int, int)> job;
+	int jobBegin = 0;
+	int jobEnd = 0;
+	int jobGrain = 1;
+	std::atomic<int> nextChunk;
+	unsigned int generation = 0;
+	int busyWorkers = 0;
+	bool quit = false;
+
+	void Worker();
+	void RunChunks();
+
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	int ThreadCount() const { return int(workers.size()) + 1; }
+
+	// Calls func(chunkBegin, chunkEnd) for consecutive chunks of at most grain
+	// items covering [begin, end), returning once every chunk is done.
+	void ParallelFor(int begin, int end, int grain, std::function<void (int, int)> func);
+};
+
+#endif // THREADPOOL_H
@@ -58,8 +58,16 @@ RNG::RNG()
 
 void RNG::seed(unsigned int sd)
 {
-	s[0] = sd;
-	s[1] = sd;
+	// expand the seed with splitmix64 as recommended by the xoroshiro authors;
+	// this also keeps a seed of 0 from producing the all-zero state
+	uint64_t x = sd;
+	for (auto &word : s)
+	{
+		uint64_t z = (x += UINT64_C(0x9E3779B97F4A7C15));
+		z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+		z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+		word = z ^ (z >> 31);
+	}
 }
 
 RNG random_gen;
@@ -2,13 +2,17 @@
 #define TPT_RAND_
 #include "Config.h"
 
+#include <array>
 #include <stdint.h>
 #include "Singleton.h"
 
 class RNG : public Singleton<RNG>
 {
+public:
+	using State = std::array<uint64_t, 2>;
+
 private:
-	uint64_t s[2];
+	State s;
 	uint64_t next();
 public:
 	unsigned int operator()();
@@ -19,6 +23,15 @@ public:
 
 	RNG();
 	void seed(unsigned int sd);
+
+	State state() const
+	{
+		return s;
+	}
+	void state(State ns)
+	{
+		s = ns;
+	}
 };
 
 extern RNG random_gen;
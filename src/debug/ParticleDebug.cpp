@@ -5,6 +5,9 @@
 
 #include "simulation/Simulation.h"
 
+#include <algorithm>
+#include <cstring>
+
 ParticleDebug::ParticleDebug(unsigned int id, Simulation * sim, GameModel * model, GameController * c):
 	DebugInfo(id),
 	sim(sim),
@@ -44,13 +47,55 @@ int ParticleDebug::updateSimOneParticle()
 
 int ParticleDebug::UpdateSimUpToInterestingChange()
 {
-	int i;
-	do
+	ParticleBreakpoint interestingChange{};
+	interestingChange.kind = ParticleBreakpoint::InterestingChange;
+	sim->debug_breakpoints.push_back(interestingChange);
+	int i = sim->StepParticles();
+	sim->debug_breakpoints.pop_back();
+	return i;
+}
+
+static String FormatWatchedValue(StructProperty::PropertyType type, uint32_t value)
+{
+	switch (type)
 	{
-		i = updateSimOneParticle();
+	case StructProperty::Float:
+		{
+			float floatValue;
+			std::memcpy(&floatValue, &value, sizeof(floatValue));
+			return String::Build(floatValue);
+		}
+
+	case StructProperty::UInteger:
+	case StructProperty::Colour:
+		return String::Build(value);
+
+	default:
+		return String::Build(int32_t(value));
 	}
-	while(i < NPART && !sim->debug_interestingChangeOccurred);
-	return i;
+}
+
+void ParticleDebug::LogBreakpointHits()
+{
+	constexpr size_t maxLogged = 20;
+	auto &properties = Particle::GetProperties();
+	auto &hits = sim->debug_breakpointHits;
+	for (size_t i = 0; i < hits.size() && i < maxLogged; i++)
+	{
+		auto &hit = hits[i];
+		auto prop = std::find_if(properties.begin(), properties.end(), [&hit](StructProperty const &p) {
+			return size_t(p.Offset) == hit.offset;
+		});
+		if (prop == properties.end())
+			continue;
+		String particle = hit.particle >= 0 ? String::Build("#", hit.particle) : String("nothing");
+		String writer = sim->IsElement(hit.writerType) ? sim->elements[hit.writerType].Name : String("?");
+		model->Log(String::Build("#", hit.writer, " (", writer, ") changed ", prop->Name.FromUtf8(), " of ", particle, " from ",
+			FormatWatchedValue(prop->Type, hit.oldValue), " to ", FormatWatchedValue(prop->Type, hit.newValue)), false);
+	}
+	if (hits.size() > maxLogged)
+		model->Log(String::Build("... and ", hits.size() - maxLogged, " more watchpoint hits"), false);
+	hits.clear();
 }
 
 void ParticleDebug::Debug(int mode, int x, int y)
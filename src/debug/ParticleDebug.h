@@ -14,6 +14,7 @@ class ParticleDebug : public DebugInfo
 public:
 	ParticleDebug(unsigned int id, Simulation * sim, GameModel * model, GameController * c);
 	int UpdateSimUpToInterestingChange();
+	void LogBreakpointHits();
 	void Debug(int mode, int x, int y);
 	bool KeyPress(int key, int scan, bool shift, bool ctrl, bool alt, ui::Point currentMouse) override;
 	virtual ~ParticleDebug();
@@ -0,0 +1,113 @@
+#include "ProfilerDebug.h"
+
+#include "gui/interface/Engine.h"
+
+#include "simulation/Simulation.h"
+
+#include "graphics/Graphics.h"
+
+#include <algorithm>
+#include <vector>
+
+constexpr int sampleFrames = 30;
+constexpr int shownElements = 12;
+
+ProfilerDebug::ProfilerDebug(unsigned int id, Simulation * sim):
+	DebugInfo(id),
+	sim(sim),
+	haveSample(false)
+{
+
+}
+
+static String TicksPerFrame(uint64_t ticks, int frames)
+{
+	return String::Build(Format::Precision(ticks / 1000.0 / std::max(frames, 1), 1), "k");
+}
+
+static String Percentage(uint64_t ticks, uint64_t total)
+{
+	return String::Build(Format::Precision(total ? ticks * 100.0 / total : 0.0, 1), "%");
+}
+
+void ProfilerDebug::Draw()
+{
+	Graphics * g = ui::Engine::Ref().g;
+	auto &profiler = sim->profiler;
+
+	if (!haveSample || profiler.frames < lastSample.frames)
+	{
+		lastSample = profiler;
+		haveSample = true;
+	}
+	else if (profiler.frames - lastSample.frames >= sampleFrames)
+	{
+		shown.frames = profiler.frames - lastSample.frames;
+		for (int phase = 0; phase < SimulationProfiler::PhaseCount; phase++)
+			shown.phaseTicks[phase] = profiler.phaseTicks[phase] - lastSample.phaseTicks[phase];
+		for (int counter = 0; counter < SimulationProfiler::CounterCount; counter++)
+			shown.counters[counter] = profiler.counters[counter] - lastSample.counters[counter];
+		for (int t = 0; t < PT_NUM; t++)
+		{
+			shown.elementTicks[t] = profiler.elementTicks[t] - lastSample.elementTicks[t];
+			shown.elementUpdates[t] = profiler.elementUpdates[t] - lastSample.elementUpdates[t];
+		}
+		lastSample = profiler;
+	}
+
+	std::vector<int> elements;
+	for (int t = 1; t < PT_NUM; t++)
+		if (shown.elementUpdates[t])
+			elements.push_back(t);
+	std::sort(elements.begin(), elements.end(), [this](int a, int b) {
+		return shown.elementTicks[a] > shown.elementTicks[b];
+	});
+	if (elements.size() > shownElements)
+		elements.resize(shownElements);
+
+	int lines = 2 + SimulationProfiler::PhaseCount + SimulationProfiler::CounterCount + 1 + int(elements.size());
+	int xStart = XRES - 210, y = 20;
+	int column2 = xStart + 100, column3 = xStart + 150;
+	g->fillrect(xStart - 5, y - 5, 210, lines * 12 + 8, 0, 0, 0, 180);
+
+	uint64_t total = shown.TotalTicks();
+	if (!profiler.enabled)
+	{
+		g->drawtext(xStart, y, "Profiler disabled", 255, 100, 100, 255);
+	}
+	else
+	{
+		g->drawtext(xStart, y, String::Build("Per frame, last ", shown.frames, " frames"), 255, 255, 255, 255);
+	}
+	y += 12;
+	g->drawtext(xStart, y, "Total", 255, 255, 255, 255);
+	g->drawtext(column2, y, TicksPerFrame(total, shown.frames), 255, 255, 255, 255);
+	y += 12;
+	for (int phase = 0; phase < SimulationProfiler::PhaseCount; phase++)
+	{
+		g->drawtext(xStart, y, ByteString(SimulationProfiler::PhaseName(phase)).FromAscii(), 200, 200, 255, 255);
+		g->drawtext(column2, y, TicksPerFrame(shown.phaseTicks[phase], shown.frames), 255, 255, 255, 255);
+		g->drawtext(column3, y, Percentage(shown.phaseTicks[phase], total), 255, 255, 255, 255);
+		y += 12;
+	}
+	for (int counter = 0; counter < SimulationProfiler::CounterCount; counter++)
+	{
+		g->drawtext(xStart, y, ByteString(SimulationProfiler::CounterName(counter)).FromAscii(), 200, 255, 200, 255);
+		g->drawtext(column2, y, String::Build(shown.counters[counter] / std::max(shown.frames, 1)), 255, 255, 255, 255);
+		y += 12;
+	}
+	y += 12;
+	for (auto t : elements)
+	{
+		auto &element = sim->elements[t];
+		g->drawtext(xStart, y, element.Name, PIXR(element.Colour), PIXG(element.Colour), PIXB(element.Colour), 255);
+		g->drawtext(column2, y, TicksPerFrame(shown.elementTicks[t], shown.frames), 255, 255, 255, 255);
+		g->drawtext(column3, y, Percentage(shown.elementTicks[t], total), 255, 255, 255, 255);
+		y += 12;
+	}
+}
+
+ProfilerDebug::~ProfilerDebug()
+{
+
+}
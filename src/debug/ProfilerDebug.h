@@ -0,0 +1,18 @@
+#pragma once
+
+#include "DebugInfo.h"
+
+#include "simulation/SimulationProfiler.h"
+
+class Simulation;
+class ProfilerDebug : public DebugInfo
+{
+	Simulation * sim;
+	// The table shows the difference between the last two samples, taken every sampleFrames frames
+	SimulationProfiler lastSample, shown;
+	bool haveSample;
+public:
+	ProfilerDebug(unsigned int id, Simulation * sim);
+	void Draw() override;
+	virtual ~ProfilerDebug();
+};
@@ -4,6 +4,7 @@
 #include "font.bz2.h"
 
 #include <array>
+#include <mutex>
 
 unsigned char *font_data = nullptr;
 unsigned int *font_ptrs = nullptr;
@@ -82,12 +83,15 @@ static bool InitFontData()
 
 unsigned char const *FontReader::lookupChar(String::value_type ch)
 {
-	if (!font_data)
+	// the first lookup can come from several threads at once, the renderer draws particles in parallel bands
+	static std::once_flag fontDataOnce;
+	static bool fontDataCorrupt = false;
+	std::call_once(fontDataOnce, []() {
+		fontDataCorrupt = !font_data && !InitFontData();
+	});
+	if (fontDataCorrupt)
 	{
-		if (!InitFontData())
-		{
-			throw std::runtime_error("font data corrupt");
-		}
+		throw std::runtime_error("font data corrupt");
 	}
 	size_t offset = 0;
 	for(int i = 0; font_ranges[i][1]; i++)
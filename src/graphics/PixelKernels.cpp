@@ -0,0 +1,258 @@
+#include "PixelKernels.h"
+
+#include <algorithm>
+
+// native builds leave the x86_sse option out of it, so also go by what the compiler targets
+#if (defined(X86_SSE2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && !defined(PIX16)
+# define PIXELKERNELS_SSE2
+# include <emmintrin.h>
+#endif
+#if (defined(X86_AVX2) || defined(__AVX2__)) && !defined(PIX16)
+# define PIXELKERNELS_AVX2
+# include <immintrin.h>
+#endif
+
+// The channels of a pixel that PIXRGB fills in from r, g and b, and what it puts in the rest
+static const unsigned int rgbMask = PIXRGB(255, 255, 255) & ~PIXRGB(0, 0, 0);
+static const unsigned int rgbBase = PIXRGB(0, 0, 0);
+
+static inline void AddPixel(pixel *dest, int r, int g, int b, int a)
+{
+	pixel t = *dest;
+	r = (a*r + 255*PIXR(t)) >> 8;
+	g = (a*g + 255*PIXG(t)) >> 8;
+	b = (a*b + 255*PIXB(t)) >> 8;
+	if (r>255)
+		r = 255;
+	if (g>255)
+		g = 255;
+	if (b>255)
+		b = 255;
+	*dest = PIXRGB(r,g,b);
+}
+
+void PixelKernels::FadePlain(const pixel *src, pixel *dest, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		int r = PIXR(src[i]);
+		int g = PIXG(src[i]);
+		int b = PIXB(src[i]);
+		if (r>0)
+			r--;
+		if (g>0)
+			g--;
+		if (b>0)
+			b--;
+		dest[i] = PIXRGB(r,g,b);
+	}
+}
+
+void PixelKernels::BlendPlain(pixel *dest, int count, int r, int g, int b, int a)
+{
+	if (a == 255)
+	{
+		std::fill(dest, dest + count, pixel(PIXRGB(r,g,b)));
+		return;
+	}
+	for (int i = 0; i < count; i++)
+	{
+		pixel t = dest[i];
+		dest[i] = PIXRGB((a*r + (255-a)*PIXR(t)) >> 8, (a*g + (255-a)*PIXG(t)) >> 8, (a*b + (255-a)*PIXB(t)) >> 8);
+	}
+}
+
+void PixelKernels::AddFireSplatPlain(pixel *dest, int stride, int r, int g, int b, const unsigned int (*alpha)[CELL*3], bool halveAlpha)
+{
+	for (int y = 0; y < CELL*3; y++)
+		for (int x = 0; x < CELL*3; x++)
+		{
+			int a = alpha[y][x];
+			if (halveAlpha)
+				a /= 2;
+			AddPixel(dest + y*stride + x, r, g, b, a);
+		}
+}
+
+#ifdef PIXELKERNELS_SSE2
+static void FadeSSE2(const pixel *src, pixel *dest, int count)
+{
+	__m128i one = _mm_set1_epi32(PIXRGB(1, 1, 1) & rgbMask);
+	__m128i mask = _mm_set1_epi32(rgbMask);
+	__m128i base = _mm_set1_epi32(rgbBase);
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		v = _mm_or_si128(_mm_and_si128(_mm_subs_epu8(v, one), mask), base);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), v);
+	}
+	PixelKernels::FadePlain(src + i, dest + i, count - i);
+}
+
+static void BlendSSE2(pixel *dest, int count, int r, int g, int b, int a)
+{
+	if (a == 255)
+	{
+		PixelKernels::BlendPlain(dest, count, r, g, b, a);
+		return;
+	}
+	__m128i zero = _mm_setzero_si128();
+	__m128i weighted = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(PIXRGB(r, g, b)), zero), _mm_set1_epi16(a));
+	__m128i inverse = _mm_set1_epi16(255 - a);
+	__m128i mask = _mm_set1_epi32(rgbMask);
+	__m128i base = _mm_set1_epi32(rgbBase);
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dest + i));
+		// a*colour + (255-a)*old is at most 255*255, so 16 bits are enough
+		__m128i lo = _mm_srli_epi16(_mm_add_epi16(weighted, _mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), inverse)), 8);
+		__m128i hi = _mm_srli_epi16(_mm_add_epi16(weighted, _mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), inverse)), 8);
+		v = _mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), mask), base);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), v);
+	}
+	PixelKernels::BlendPlain(dest + i, count - i, r, g, b, a);
+}
+
+// AddPixel on four pixels. colour is PIXRGB(r, g, b) widened to 16 bit channels, twice.
+static inline void AddFourSSE2(pixel *dest, __m128i colour, const unsigned int *alpha, bool halveAlpha)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(alpha));
+	if (halveAlpha)
+		a = _mm_srli_epi32(a, 1);
+	// (alpha, 255) pairs to multiply (colour, old) pairs with
+	a = _mm_unpacklo_epi16(_mm_packs_epi32(a, a), _mm_set1_epi16(255));
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dest));
+	__m128i lo = _mm_unpacklo_epi8(v, zero);
+	__m128i hi = _mm_unpackhi_epi8(v, zero);
+	__m128i sum0 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(colour, lo), _mm_shuffle_epi32(a, 0x00)), 8);
+	__m128i sum1 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(colour, lo), _mm_shuffle_epi32(a, 0x55)), 8);
+	__m128i sum2 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(colour, hi), _mm_shuffle_epi32(a, 0xAA)), 8);
+	__m128i sum3 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(colour, hi), _mm_shuffle_epi32(a, 0xFF)), 8);
+	// both packs saturate, which clamps the channels to 255
+	v = _mm_packus_epi16(_mm_packs_epi32(sum0, sum1), _mm_packs_epi32(sum2, sum3));
+	v = _mm_or_si128(_mm_and_si128(v, _mm_set1_epi32(rgbMask)), _mm_set1_epi32(rgbBase));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(dest), v);
+}
+#endif
+
+#ifdef PIXELKERNELS_AVX2
+static void FadeAVX2(const pixel *src, pixel *dest, int count)
+{
+	__m256i one = _mm256_set1_epi32(PIXRGB(1, 1, 1) & rgbMask);
+	__m256i mask = _mm256_set1_epi32(rgbMask);
+	__m256i base = _mm256_set1_epi32(rgbBase);
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+		v = _mm256_or_si256(_mm256_and_si256(_mm256_subs_epu8(v, one), mask), base);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), v);
+	}
+	FadeSSE2(src + i, dest + i, count - i);
+}
+
+static void BlendAVX2(pixel *dest, int count, int r, int g, int b, int a)
+{
+	if (a == 255)
+	{
+		PixelKernels::BlendPlain(dest, count, r, g, b, a);
+		return;
+	}
+	__m256i zero = _mm256_setzero_si256();
+	__m256i weighted = _mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32(PIXRGB(r, g, b)), zero), _mm256_set1_epi16(a));
+	__m256i inverse = _mm256_set1_epi16(255 - a);
+	__m256i mask = _mm256_set1_epi32(rgbMask);
+	__m256i base = _mm256_set1_epi32(rgbBase);
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest + i));
+		__m256i lo = _mm256_srli_epi16(_mm256_add_epi16(weighted, _mm256_mullo_epi16(_mm256_unpacklo_epi8(v, zero), inverse)), 8);
+		__m256i hi = _mm256_srli_epi16(_mm256_add_epi16(weighted, _mm256_mullo_epi16(_mm256_unpackhi_epi8(v, zero), inverse)), 8);
+		v = _mm256_or_si256(_mm256_and_si256(_mm256_packus_epi16(lo, hi), mask), base);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), v);
+	}
+	BlendSSE2(dest + i, count - i, r, g, b, a);
+}
+
+// AddFourSSE2 on eight pixels, every step works within 128 bit halves in the same way
+static inline void AddEightAVX2(pixel *dest, __m256i colour, const unsigned int *alpha, bool halveAlpha)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(alpha));
+	if (halveAlpha)
+		a = _mm256_srli_epi32(a, 1);
+	a = _mm256_unpacklo_epi16(_mm256_packs_epi32(a, a), _mm256_set1_epi16(255));
+	__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest));
+	__m256i lo = _mm256_unpacklo_epi8(v, zero);
+	__m256i hi = _mm256_unpackhi_epi8(v, zero);
+	__m256i sum0 = _mm256_srli_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(colour, lo), _mm256_shuffle_epi32(a, 0x00)), 8);
+	__m256i sum1 = _mm256_srli_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(colour, lo), _mm256_shuffle_epi32(a, 0x55)), 8);
+	__m256i sum2 = _mm256_srli_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(colour, hi), _mm256_shuffle_epi32(a, 0xAA)), 8);
+	__m256i sum3 = _mm256_srli_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(colour, hi), _mm256_shuffle_epi32(a, 0xFF)), 8);
+	v = _mm256_packus_epi16(_mm256_packs_epi32(sum0, sum1), _mm256_packs_epi32(sum2, sum3));
+	v = _mm256_or_si256(_mm256_and_si256(v, _mm256_set1_epi32(rgbMask)), _mm256_set1_epi32(rgbBase));
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest), v);
+}
+#endif
+
+const char *PixelKernels::Name()
+{
+#if defined(PIXELKERNELS_AVX2)
+	return "AVX2";
+#elif defined(PIXELKERNELS_SSE2)
+	return "SSE2";
+#else
+	return "plain";
+#endif
+}
+
+void PixelKernels::Fade(const pixel *src, pixel *dest, int count)
+{
+#if defined(PIXELKERNELS_AVX2)
+	FadeAVX2(src, dest, count);
+#elif defined(PIXELKERNELS_SSE2)
+	FadeSSE2(src, dest, count);
+#else
+	FadePlain(src, dest, count);
+#endif
+}
+
+void PixelKernels::Blend(pixel *dest, int count, int r, int g, int b, int a)
+{
+#if defined(PIXELKERNELS_AVX2)
+	BlendAVX2(dest, count, r, g, b, a);
+#elif defined(PIXELKERNELS_SSE2)
+	BlendSSE2(dest, count, r, g, b, a);
+#else
+	BlendPlain(dest, count, r, g, b, a);
+#endif
+}
+
+void PixelKernels::AddFireSplat(pixel *dest, int stride, int r, int g, int b, const unsigned int (*alpha)[CELL*3], bool halveAlpha)
+{
+#ifdef PIXELKERNELS_SSE2
+	__m128i colour = _mm_unpacklo_epi8(_mm_set1_epi32(PIXRGB(r, g, b)), _mm_setzero_si128());
+# ifdef PIXELKERNELS_AVX2
+	__m256i colour8 = _mm256_unpacklo_epi8(_mm256_set1_epi32(PIXRGB(r, g, b)), _mm256_setzero_si256());
+# endif
+	for (int y = 0; y < CELL*3; y++)
+	{
+		pixel *row = dest + y*stride;
+		int x = 0;
+# ifdef PIXELKERNELS_AVX2
+		for (; x + 8 <= CELL*3; x += 8)
+			AddEightAVX2(row + x, colour8, alpha[y] + x, halveAlpha);
+# endif
+		for (; x + 4 <= CELL*3; x += 4)
+			AddFourSSE2(row + x, colour, alpha[y] + x, halveAlpha);
+		for (; x < CELL*3; x++)
+			AddPixel(row + x, r, g, b, halveAlpha ? int(alpha[y][x]) / 2 : int(alpha[y][x]));
+	}
+#else
+	AddFireSplatPlain(dest, stride, r, g, b, alpha, halveAlpha);
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+#include "Config.h"
+
+#include "Pixel.h"
+
+// The loops of the renderer that do the same thing to long runs of pixels. Each has a
+// plain version, which is always built, and SSE2 and AVX2 versions that are used instead
+// when the x86_sse build option or the compiler's target (as with native) allows them.
+// They give exactly the same pixels as the plain ones, which `runner --check-kernels`
+// verifies.
+namespace PixelKernels
+{
+	// Name of the instruction set the kernels in use are written for
+	const char *Name();
+
+	// Takes 1 off every channel of count pixels of src and stores them in dest,
+	// the fading of the persistent display mode
+	void Fade(const pixel *src, pixel *dest, int count);
+	void FadePlain(const pixel *src, pixel *dest, int count);
+
+	// Does what Renderer::blendpixel does to count pixels in a row, 0 <= a <= 255
+	void Blend(pixel *dest, int count, int r, int g, int b, int a);
+	void BlendPlain(pixel *dest, int count, int r, int g, int b, int a);
+
+	// Does what Renderer::addpixel does to each pixel of a CELL*3 by CELL*3 block, with the
+	// alpha taken from the same place in alpha and halved if halveAlpha is set. dest is the top
+	// left pixel of the block, rows are stride pixels apart. The alphas must be below 32768.
+	void AddFireSplat(pixel *dest, int stride, int r, int g, int b, const unsigned int (*alpha)[CELL*3], bool halveAlpha);
+	void AddFireSplatPlain(pixel *dest, int stride, int r, int g, int b, const unsigned int (*alpha)[CELL*3], bool halveAlpha);
+}
+
+#endif
@@ -1,6 +1,9 @@
 #include "Renderer.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -8,7 +11,10 @@
 #include <cstdlib>
 #include "Config.h"
 #include "Misc.h"
+#include "FontReader.h"
+#include "PixelKernels.h"
 
+#include "common/ThreadPool.h"
 #include "common/tpt-rand.h"
 #include "common/tpt-compat.h"
 
@@ -74,20 +80,7 @@ void Renderer::RenderBegin()
 	render_parts();
 	if(display_mode & DISPLAY_PERS)
 	{
-		int i,r,g,b;
-		for (i = 0; i < VIDXRES*YRES; i++)
-		{
-			r = PIXR(vid[i]);
-			g = PIXG(vid[i]);
-			b = PIXB(vid[i]);
-			if (r>0)
-				r--;
-			if (g>0)
-				g--;
-			if (b>0)
-				b--;
-			persistentVid[i] = PIXRGB(r,g,b);
-		}
+		PixelKernels::Fade(vid, persistentVid, VIDXRES*YRES);
 	}
 
 	render_fire();
@@ -100,6 +93,15 @@ void Renderer::RenderBegin()
 	}
 #endif
 #else
+#ifndef FONTEDITOR
+	if (retainFrame && !(display_mode & (DISPLAY_PERS | DISPLAY_WARP)))
+	{
+		render_retained();
+		return;
+	}
+	retainedValid = false;
+#endif
+
 	if(display_mode & DISPLAY_PERS)
 	{
 		std::copy(persistentVid, persistentVid+(VIDXRES*YRES), vid);
@@ -120,20 +122,7 @@ void Renderer::RenderBegin()
 	
 	if(display_mode & DISPLAY_PERS)
 	{
-		int i,r,g,b;
-		for (i = 0; i < VIDXRES*YRES; i++)
-		{
-			r = PIXR(vid[i]);
-			g = PIXG(vid[i]);
-			b = PIXB(vid[i]);
-			if (r>0)
-				r--;
-			if (g>0)
-				g--;
-			if (b>0)
-				b--;
-			persistentVid[i] = PIXRGB(r,g,b);
-		}
+		PixelKernels::Fade(vid, persistentVid, VIDXRES*YRES);
 	}
 
 	render_fire();
@@ -735,249 +724,263 @@ void Renderer::DrawWalls()
 	glTranslated(0, -MENUSIZE, 0);
 #else
 	for (int y = 0; y < YRES/CELL; y++)
-		for (int x =0; x < XRES/CELL; x++)
-			if (sim->bmap[y][x])
+		for (int x = 0; x < XRES/CELL; x++)
+			if (sim->bmap[y][x] && sim->bmap[y][x] < UI_WALLCOUNT)
 			{
-				unsigned char wt = sim->bmap[y][x];
-				if (wt >= UI_WALLCOUNT)
-					continue;
-				unsigned char powered = sim->emap[y][x];
-				pixel pc = PIXPACK(sim->wtypes[wt].colour);
-				pixel gc = PIXPACK(sim->wtypes[wt].eglow);
+				draw_wall(x, y);
+				glow_wall(x, y);
+			}
+#endif
+}
 
-				if (findingElement)
-				{
-					pc = PIXRGB(PIXR(pc)/10,PIXG(pc)/10,PIXB(pc)/10);
-					gc = PIXRGB(PIXR(gc)/10,PIXG(gc)/10,PIXB(gc)/10);
-				}
+#ifndef OGLR
+// Draws the wall in cell (x, y), which only touches the pixels of that cell unless it's a
+// streamline or blobs are on
+void Renderer::draw_wall(int x, int y)
+{
+	unsigned char wt = sim->bmap[y][x];
+	unsigned char powered = sim->emap[y][x];
+	pixel pc = PIXPACK(sim->wtypes[wt].colour);
+	pixel gc = PIXPACK(sim->wtypes[wt].eglow);
 
-				switch (sim->wtypes[wt].drawstyle)
-				{
-				case 0:
-					if (wt == WL_EWALL || wt == WL_STASIS)
-					{
-						bool reverse = wt == WL_STASIS;
-						if ((powered > 0) ^ reverse)
-						{
-							for (int j = 0; j < CELL; j++)
-								for (int i =0; i < CELL; i++)
-									if (i&j&1)
-										vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
-						}
-						else
-						{
-							for (int j = 0; j < CELL; j++)
-								for (int i = 0; i < CELL; i++)
-									if (!(i&j&1))
-										vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
-						}
-					}
-					else if (wt == WL_WALLELEC)
-					{
-						for (int j = 0; j < CELL; j++)
-							for (int i = 0; i < CELL; i++)
-							{
-								if (!((y*CELL+j)%2) && !((x*CELL+i)%2))
-									vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
-								else
-									vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x808080);
-							}
-					}
-					else if (wt == WL_EHOLE)
-					{
-						if (powered)
-						{
-							for (int j = 0; j < CELL; j++)
-								for (int i = 0; i < CELL; i++)
-									vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x242424);
-							for (int j = 0; j < CELL; j += 2)
-								for (int i = 0; i < CELL; i += 2)
-									vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x000000);
-						}
-						else
-						{
-							for (int j = 0; j < CELL; j += 2)
-								for (int i =0; i < CELL; i += 2)
-									vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x242424);
-						}
-					}
-					else if (wt == WL_STREAM)
-					{
-						float xf = x*CELL + CELL*0.5f;
-						float yf = y*CELL + CELL*0.5f;
-						int oldX = (int)(xf+0.5f), oldY = (int)(yf+0.5f);
-						int newX, newY;
-						float xVel = sim->vx[y][x]*0.125f, yVel = sim->vy[y][x]*0.125f;
-						// there is no velocity here, draw a streamline and continue
-						if (!xVel && !yVel)
-						{
-							drawtext(x*CELL, y*CELL-2, 0xE00D, 255, 255, 255, 128);
-							addpixel(oldX, oldY, 255, 255, 255, 255);
-							continue;
-						}
-						bool changed = false;
-						for (int t = 0; t < 1024; t++)
-						{
-							newX = (int)(xf+0.5f);
-							newY = (int)(yf+0.5f);
-							if (newX != oldX || newY != oldY)
-							{
-								changed = true;
-								oldX = newX;
-								oldY = newY;
-							}
-							if (changed && (newX<0 || newX>=XRES || newY<0 || newY>=YRES))
-								break;
-							addpixel(newX, newY, 255, 255, 255, 64);
-							// cache velocity and other checks so we aren't running them constantly
-							if (changed)
-							{
-								int wallX = newX/CELL;
-								int wallY = newY/CELL;
-								xVel = sim->vx[wallY][wallX]*0.125f;
-								yVel = sim->vy[wallY][wallX]*0.125f;
-								if (wallX != x && wallY != y && sim->bmap[wallY][wallX] == WL_STREAM)
-									break;
-							}
-							xf += xVel;
-							yf += yVel;
-						}
-						drawtext(x*CELL, y*CELL-2, 0xE00D, 255, 255, 255, 128);
-					}
-					break;
-				case 1:
-					for (int j = 0; j < CELL; j += 2)
-						for (int i = (j>>1)&1; i < CELL; i += 2)
-							vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
-					break;
-				case 2:
-					for (int j = 0; j < CELL; j += 2)
-						for (int i = 0; i < CELL; i += 2)
+	if (findingElement)
+	{
+		pc = PIXRGB(PIXR(pc)/10,PIXG(pc)/10,PIXB(pc)/10);
+		gc = PIXRGB(PIXR(gc)/10,PIXG(gc)/10,PIXB(gc)/10);
+	}
+
+	switch (sim->wtypes[wt].drawstyle)
+	{
+	case 0:
+		if (wt == WL_EWALL || wt == WL_STASIS)
+		{
+			bool reverse = wt == WL_STASIS;
+			if ((powered > 0) ^ reverse)
+			{
+				for (int j = 0; j < CELL; j++)
+					for (int i =0; i < CELL; i++)
+						if (i&j&1)
 							vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
-					break;
-				case 3:
-					for (int j = 0; j < CELL; j++)
-						for (int i = 0; i < CELL; i++)
+			}
+			else
+			{
+				for (int j = 0; j < CELL; j++)
+					for (int i = 0; i < CELL; i++)
+						if (!(i&j&1))
 							vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
+			}
+		}
+		else if (wt == WL_WALLELEC)
+		{
+			for (int j = 0; j < CELL; j++)
+				for (int i = 0; i < CELL; i++)
+				{
+					if (!((y*CELL+j)%2) && !((x*CELL+i)%2))
+						vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
+					else
+						vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x808080);
+				}
+		}
+		else if (wt == WL_EHOLE)
+		{
+			if (powered)
+			{
+				for (int j = 0; j < CELL; j++)
+					for (int i = 0; i < CELL; i++)
+						vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x242424);
+				for (int j = 0; j < CELL; j += 2)
+					for (int i = 0; i < CELL; i += 2)
+						vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x000000);
+			}
+			else
+			{
+				for (int j = 0; j < CELL; j += 2)
+					for (int i =0; i < CELL; i += 2)
+						vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x242424);
+			}
+		}
+		else if (wt == WL_STREAM)
+		{
+			float xf = x*CELL + CELL*0.5f;
+			float yf = y*CELL + CELL*0.5f;
+			int oldX = (int)(xf+0.5f), oldY = (int)(yf+0.5f);
+			int newX, newY;
+			float xVel = sim->vx[y][x]*0.125f, yVel = sim->vy[y][x]*0.125f;
+			// there is no velocity here, draw a streamline and continue
+			if (!xVel && !yVel)
+			{
+				drawtext(x*CELL, y*CELL-2, 0xE00D, 255, 255, 255, 128);
+				addpixel(oldX, oldY, 255, 255, 255, 255);
+				return;
+			}
+			bool changed = false;
+			for (int t = 0; t < 1024; t++)
+			{
+				newX = (int)(xf+0.5f);
+				newY = (int)(yf+0.5f);
+				if (newX != oldX || newY != oldY)
+				{
+					changed = true;
+					oldX = newX;
+					oldY = newY;
+				}
+				if (changed && (newX<0 || newX>=XRES || newY<0 || newY>=YRES))
 					break;
-				case 4:
-					for (int j = 0; j < CELL; j++)
-						for (int i = 0; i < CELL; i++)
-							if (i == j)
-								vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
-							else if (i == j+1 || (i == 0 && j == CELL-1))
-								vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = gc;
-							else
-								vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x202020);
-					break;
+				addpixel(newX, newY, 255, 255, 255, 64);
+				// cache velocity and other checks so we aren't running them constantly
+				if (changed)
+				{
+					int wallX = newX/CELL;
+					int wallY = newY/CELL;
+					xVel = sim->vx[wallY][wallX]*0.125f;
+					yVel = sim->vy[wallY][wallX]*0.125f;
+					if (wallX != x && wallY != y && sim->bmap[wallY][wallX] == WL_STREAM)
+						break;
 				}
+				xf += xVel;
+				yf += yVel;
+			}
+			drawtext(x*CELL, y*CELL-2, 0xE00D, 255, 255, 255, 128);
+		}
+		break;
+	case 1:
+		for (int j = 0; j < CELL; j += 2)
+			for (int i = (j>>1)&1; i < CELL; i += 2)
+				vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
+		break;
+	case 2:
+		for (int j = 0; j < CELL; j += 2)
+			for (int i = 0; i < CELL; i += 2)
+				vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
+		break;
+	case 3:
+		for (int j = 0; j < CELL; j++)
+			for (int i = 0; i < CELL; i++)
+				vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
+		break;
+	case 4:
+		for (int j = 0; j < CELL; j++)
+			for (int i = 0; i < CELL; i++)
+				if (i == j)
+					vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = pc;
+				else if (i == j+1 || (i == 0 && j == CELL-1))
+					vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = gc;
+				else
+					vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x202020);
+		break;
+	}
 
-				// when in blob view, draw some blobs...
-				if (render_mode & PMODE_BLOB)
+	// when in blob view, draw some blobs...
+	if (render_mode & PMODE_BLOB)
+	{
+		switch (sim->wtypes[wt].drawstyle)
+		{
+		case 0:
+			if (wt == WL_EWALL || wt == WL_STASIS)
+			{
+				bool reverse = wt == WL_STASIS;
+				if ((powered>0) ^ reverse)
 				{
-					switch (sim->wtypes[wt].drawstyle)
-					{
-					case 0:
-						if (wt == WL_EWALL || wt == WL_STASIS)
-						{
-							bool reverse = wt == WL_STASIS;
-							if ((powered>0) ^ reverse)
-							{
-								for (int j = 0; j < CELL; j++)
-									for (int i =0; i < CELL; i++)
-										if (i&j&1)
-											drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
-							}
-							else
-							{
-								for (int j = 0; j < CELL; j++)
-									for (int i = 0; i < CELL; i++)
-										if (!(i&j&1))
-											drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
-							}
-						}
-						else if (wt == WL_WALLELEC)
-						{
-							for (int j = 0; j < CELL; j++)
-								for (int i =0; i < CELL; i++)
-								{
-									if (!((y*CELL+j)%2) && !((x*CELL+i)%2))
-										drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
-									else
-										drawblob((x*CELL+i), (y*CELL+j), 0x80, 0x80, 0x80);
-								}
-						}
-						else if (wt == WL_EHOLE)
-						{
-							if (powered)
-							{
-								for (int j = 0; j < CELL; j++)
-									for (int i = 0; i < CELL; i++)
-										drawblob((x*CELL+i), (y*CELL+j), 0x24, 0x24, 0x24);
-								for (int j = 0; j < CELL; j += 2)
-									for (int i = 0; i < CELL; i += 2)
-										// looks bad if drawing black blobs
-										vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x000000);
-							}
-							else
-							{
-								for (int j = 0; j < CELL; j += 2)
-									for (int i = 0; i < CELL; i += 2)
-										drawblob((x*CELL+i), (y*CELL+j), 0x24, 0x24, 0x24);
-							}
-						}
-						break;
-					case 1:
-						for (int j = 0; j < CELL; j += 2)
-							for (int i = (j>>1)&1; i < CELL; i += 2)
-								drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
-						break;
-					case 2:
-						for (int j = 0; j < CELL; j += 2)
-							for (int i = 0; i < CELL; i+=2)
+					for (int j = 0; j < CELL; j++)
+						for (int i =0; i < CELL; i++)
+							if (i&j&1)
 								drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
-						break;
-					case 3:
-						for (int j = 0; j < CELL; j++)
-							for (int i = 0; i < CELL; i++)
+				}
+				else
+				{
+					for (int j = 0; j < CELL; j++)
+						for (int i = 0; i < CELL; i++)
+							if (!(i&j&1))
 								drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
-						break;
-					case 4:
-						for (int j = 0; j < CELL; j++)
-							for (int i = 0; i < CELL; i++)
-								if (i == j)
-									drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
-								else if (i == j+1 || (i == 0 && j == CELL-1))
-									vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = gc;
-								else
-									// looks bad if drawing black blobs
-									vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x202020);
-						break;
+				}
+			}
+			else if (wt == WL_WALLELEC)
+			{
+				for (int j = 0; j < CELL; j++)
+					for (int i =0; i < CELL; i++)
+					{
+						if (!((y*CELL+j)%2) && !((x*CELL+i)%2))
+							drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
+						else
+							drawblob((x*CELL+i), (y*CELL+j), 0x80, 0x80, 0x80);
 					}
+			}
+			else if (wt == WL_EHOLE)
+			{
+				if (powered)
+				{
+					for (int j = 0; j < CELL; j++)
+						for (int i = 0; i < CELL; i++)
+							drawblob((x*CELL+i), (y*CELL+j), 0x24, 0x24, 0x24);
+					for (int j = 0; j < CELL; j += 2)
+						for (int i = 0; i < CELL; i += 2)
+							// looks bad if drawing black blobs
+							vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x000000);
 				}
-
-				if (sim->wtypes[wt].eglow && powered)
+				else
 				{
-					// glow if electrified
-					pixel glow = sim->wtypes[wt].eglow;
-					int alpha = 255;
-					int cr = (alpha*PIXR(glow) + (255-alpha)*fire_r[y/CELL][x/CELL]) >> 8;
-					int cg = (alpha*PIXG(glow) + (255-alpha)*fire_g[y/CELL][x/CELL]) >> 8;
-					int cb = (alpha*PIXB(glow) + (255-alpha)*fire_b[y/CELL][x/CELL]) >> 8;
-
-					if (cr > 255)
-						cr = 255;
-					if (cg > 255)
-						cg = 255;
-					if (cb > 255)
-						cb = 255;
-					fire_r[y][x] = cr;
-					fire_g[y][x] = cg;
-					fire_b[y][x] = cb;
+					for (int j = 0; j < CELL; j += 2)
+						for (int i = 0; i < CELL; i += 2)
+							drawblob((x*CELL+i), (y*CELL+j), 0x24, 0x24, 0x24);
 				}
 			}
-#endif
+			break;
+		case 1:
+			for (int j = 0; j < CELL; j += 2)
+				for (int i = (j>>1)&1; i < CELL; i += 2)
+					drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
+			break;
+		case 2:
+			for (int j = 0; j < CELL; j += 2)
+				for (int i = 0; i < CELL; i+=2)
+					drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
+			break;
+		case 3:
+			for (int j = 0; j < CELL; j++)
+				for (int i = 0; i < CELL; i++)
+					drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
+			break;
+		case 4:
+			for (int j = 0; j < CELL; j++)
+				for (int i = 0; i < CELL; i++)
+					if (i == j)
+						drawblob((x*CELL+i), (y*CELL+j), PIXR(pc), PIXG(pc), PIXB(pc));
+					else if (i == j+1 || (i == 0 && j == CELL-1))
+						vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = gc;
+					else
+						// looks bad if drawing black blobs
+						vid[(y*CELL+j)*(VIDXRES)+(x*CELL+i)] = PIXPACK(0x202020);
+			break;
+		}
+	}
+}
+
+// Lights up the fire map under the wall in cell (x, y) if it's electrified
+void Renderer::glow_wall(int x, int y)
+{
+	unsigned char wt = sim->bmap[y][x];
+	unsigned char powered = sim->emap[y][x];
+	if (sim->wtypes[wt].eglow && powered)
+	{
+		// glow if electrified
+		pixel glow = sim->wtypes[wt].eglow;
+		int alpha = 255;
+		int cr = (alpha*PIXR(glow) + (255-alpha)*fire_r[y/CELL][x/CELL]) >> 8;
+		int cg = (alpha*PIXG(glow) + (255-alpha)*fire_g[y/CELL][x/CELL]) >> 8;
+		int cb = (alpha*PIXB(glow) + (255-alpha)*fire_b[y/CELL][x/CELL]) >> 8;
+
+		if (cr > 255)
+			cr = 255;
+		if (cg > 255)
+			cg = 255;
+		if (cb > 255)
+			cb = 255;
+		fire_r[y][x] = cr;
+		fire_g[y][x] = cg;
+		fire_b[y][x] = cb;
+	}
 }
+#endif
 
 #ifndef FONTEDITOR
 void Renderer::DrawSigns()
@@ -1069,30 +1072,200 @@ void Renderer::render_gravlensing(pixel * source)
 #endif
 }
 
+#ifndef OGLR
+// Pixel drawing limited to the rectangle [left, right) by [top, bottom) of the screen, so
+// that separate bands of it can be drawn at the same time and single blocks of it can be
+// redrawn. Otherwise these do exactly what the Renderer methods of the same names do.
+class ClippedPixels
+{
+	pixel *vid;
+	int left, top, right, bottom;
+
+	template<class Plot>
+	static void line(int x1, int y1, int x2, int y2, Plot plot)
+	{
+		int cp=abs(y2-y1)>abs(x2-x1), x, y, dx, dy, sy;
+		float e, de;
+		if (cp)
+		{
+			std::swap(x1, y1);
+			std::swap(x2, y2);
+		}
+		if (x1 > x2)
+		{
+			std::swap(x1, x2);
+			std::swap(y1, y2);
+		}
+		dx = x2 - x1;
+		dy = abs(y2 - y1);
+		e = 0.0f;
+		if (dx)
+			de = dy/(float)dx;
+		else
+			de = 0.0f;
+		y = y1;
+		sy = (y1<y2) ? 1 : -1;
+		for (x=x1; x<=x2; x++)
+		{
+			if (cp)
+				plot(y, x);
+			else
+				plot(x, y);
+			e += de;
+			if (e >= 0.5f)
+			{
+				y += sy;
+				e -= 1.0f;
+			}
+		}
+	}
+
+public:
+	ClippedPixels(pixel *vid, int left, int top, int right, int bottom) :
+		vid(vid),
+		left(left),
+		top(top),
+		right(right),
+		bottom(bottom)
+	{
+	}
+
+	void setpixel(int x, int y, int r, int g, int b)
+	{
+		if (x<left || y<top || x>=right || y>=bottom)
+			return;
+		vid[y*(VIDXRES)+x] = PIXRGB(r,g,b);
+	}
+
+	void blendpixel(int x, int y, int r, int g, int b, int a)
+	{
+		pixel t;
+		if (x<left || y<top || x>=right || y>=bottom)
+			return;
+		if (a!=255)
+		{
+			t = vid[y*(VIDXRES)+x];
+			r = (a*r + (255-a)*PIXR(t)) >> 8;
+			g = (a*g + (255-a)*PIXG(t)) >> 8;
+			b = (a*b + (255-a)*PIXB(t)) >> 8;
+		}
+		vid[y*(VIDXRES)+x] = PIXRGB(r,g,b);
+	}
+
+	void addpixel(int x, int y, int r, int g, int b, int a)
+	{
+		pixel t;
+		if (x<left || y<top || x>=right || y>=bottom)
+			return;
+		t = vid[y*(VIDXRES)+x];
+		r = (a*r + 255*PIXR(t)) >> 8;
+		g = (a*g + 255*PIXG(t)) >> 8;
+		b = (a*b + 255*PIXB(t)) >> 8;
+		if (r>255)
+			r = 255;
+		if (g>255)
+			g = 255;
+		if (b>255)
+			b = 255;
+		vid[y*(VIDXRES)+x] = PIXRGB(r,g,b);
+	}
+
+	void xor_pixel(int x, int y)
+	{
+		int c;
+		if (x<0 || y<0 || x>=XRES || y>=YRES || x<left || y<top || x>=right || y>=bottom)
+			return;
+		c = vid[y*(VIDXRES)+x];
+		c = PIXB(c) + 3*PIXG(c) + 2*PIXR(c);
+		if (c<512)
+			vid[y*(VIDXRES)+x] = PIXPACK(0xC0C0C0);
+		else
+			vid[y*(VIDXRES)+x] = PIXPACK(0x404040);
+	}
+
+	void draw_line(int x1, int y1, int x2, int y2, int r, int g, int b, int a)
+	{
+		line(x1, y1, x2, y2, [this, r, g, b, a](int x, int y) {
+			blendpixel(x, y, r, g, b, a);
+		});
+	}
+
+	void xor_line(int x1, int y1, int x2, int y2)
+	{
+		line(x1, y1, x2, y2, [this](int x, int y) {
+			xor_pixel(x, y);
+		});
+	}
+
+	// only plain text, without the colour codes Renderer::drawtext understands
+	void drawtext(int x, int y, const String &str, int r, int g, int b, int a)
+	{
+		for (auto c : str)
+		{
+			FontReader reader(c);
+			for (int j = -2; j < FONT_H - 2; j++)
+				for (int i = 0; i < reader.GetWidth(); i++)
+					blendpixel(x + i, y + j, r, g, b, reader.NextPixel() * a / 3);
+			x += reader.GetWidth();
+		}
+	}
+};
+#endif
+
 void Renderer::render_fire()
 {
 #ifndef OGLR
 	if(!(render_mode & FIREMODE))
 		return;
-	int i,j,x,y,r,g,b,a;
-	for (j=0; j<YRES/CELL; j++)
-		for (i=0; i<XRES/CELL; i++)
+	draw_fire(0, 0, VIDXRES, VIDYRES);
+	decay_fire();
+#endif
+}
+
+#ifndef OGLR
+// Adds the glow of the fire map to the pixels in [left, right) by [top, bottom). Every cell
+// of the map lights up the CELL*3 by CELL*3 pixels around it.
+void Renderer::draw_fire(int left, int top, int right, int bottom)
+{
+	// the kernel takes alphas up to 0x7FFF, only fire intensities set from Lua go past that
+	bool splatKernel = std::all_of(&fire_alpha[0][0], &fire_alpha[0][0] + CELL*3*CELL*3, [](unsigned int alpha) {
+		return alpha < 0x8000;
+	});
+	ClippedPixels pixels(vid, left, top, right, bottom);
+	int firstJ = std::max(top/CELL-1, 0), lastJ = std::min((bottom-1)/CELL+1, YRES/CELL-1);
+	int firstI = std::max(left/CELL-1, 0), lastI = std::min((right-1)/CELL+1, XRES/CELL-1);
+	for (int j=firstJ; j<=lastJ; j++)
+		for (int i=firstI; i<=lastI; i++)
 		{
-			r = fire_r[j][i];
-			g = fire_g[j][i];
-			b = fire_b[j][i];
-			if (r || g || b)
-				for (y=-CELL; y<2*CELL; y++)
-					for (x=-CELL; x<2*CELL; x++)
+			int r = fire_r[j][i];
+			int g = fire_g[j][i];
+			int b = fire_b[j][i];
+			if (!(r || g || b))
+				continue;
+			if (splatKernel && (i-1)*CELL >= left && (j-1)*CELL >= top && (i+2)*CELL <= right && (j+2)*CELL <= bottom)
+				PixelKernels::AddFireSplat(vid + (j-1)*CELL*(VIDXRES) + (i-1)*CELL, VIDXRES, r, g, b, fire_alpha, findingElement != 0);
+			else
+				for (int y=std::max(-CELL, top-j*CELL); y<std::min(2*CELL, bottom-j*CELL); y++)
+					for (int x=-CELL; x<2*CELL; x++)
 					{
-						a = fire_alpha[y+CELL][x+CELL];
+						int a = fire_alpha[y+CELL][x+CELL];
 						if (findingElement)
 							a /= 2;
-						addpixel(i*CELL+x, j*CELL+y, r, g, b, a);
+						pixels.addpixel(i*CELL+x, j*CELL+y, r, g, b, a);
 					}
-			r *= 8;
-			g *= 8;
-			b *= 8;
+		}
+}
+
+// Spreads the fire map out a bit and fades it, once per frame after it's drawn
+void Renderer::decay_fire()
+{
+	int i,j,x,y,r,g,b;
+	for (j=0; j<YRES/CELL; j++)
+		for (i=0; i<XRES/CELL; i++)
+		{
+			r = fire_r[j][i]*8;
+			g = fire_g[j][i]*8;
+			b = fire_b[j][i]*8;
 			for (y=-1; y<2; y++)
 				for (x=-1; x<2; x++)
 					if ((x || y) && i+x>=0 && j+y>=0 && i+x<XRES/CELL && j+y<YRES/CELL)
@@ -1108,8 +1281,8 @@ void Renderer::render_fire()
 			fire_g[j][i] = g>4 ? g-4 : 0;
 			fire_b[j][i] = b>4 ? b-4 : 0;
 		}
-#endif
 }
+#endif
 
 float temp[CELL*3][CELL*3];
 float fire_alphaf[CELL*3][CELL*3];
@@ -1197,11 +1370,50 @@ void Renderer::prepare_alpha(int size, float intensity)
 }
 
 #ifndef FONTEDITOR
+#ifndef OGLR
+// How many pixels the arms of a spark or flare reach, they are drawn until gradv drops to 0.5
+static int flareReach(float gradv, float falloff)
+{
+	int reach = 0;
+	for (; gradv>0.5; reach++)
+		gradv = gradv/falloff;
+	return reach;
+}
+#endif
+
+#ifndef OGLR
 void Renderer::render_parts()
 {
-	int deca, decr, decg, decb, cola, colr, colg, colb, firea, firer, fireg, fireb, pixel_mode, q, i, t, nx, ny, x, y, caddress;
-	int orbd[4] = {0, 0, 0, 0}, orbl[4] = {0, 0, 0, 0};
-	float gradv, flicker;
+	if(!sim)
+		return;
+	draw_grid(0, 0, XRES, YRES);
+	record_parts();
+	draw_parts();
+}
+
+void Renderer::draw_grid(int left, int top, int right, int bottom)
+{
+	if (!gridSize)
+		return;
+	for (int ny=top; ny<std::min(bottom, YRES); ny++)
+		for (int nx=left; nx<std::min(right, XRES); nx++)
+		{
+			if (ny%(4*gridSize) == 0)
+				blendpixel(nx, ny, 100, 100, 100, 80);
+			if (nx%(4*gridSize) == 0 && ny%(4*gridSize) != 0)
+				blendpixel(nx, ny, 100, 100, 100, 80);
+		}
+}
+
+// Works out how every particle looks and what it does to the fire maps, in particle order, and
+// leaves what draw_part needs to draw them in renderedParts
+void Renderer::record_parts()
+#else
+void Renderer::render_parts()
+#endif
+{
+	int deca, decr, decg, decb, cola, colr, colg, colb, firea, firer, fireg, fireb, pixel_mode, q, i, t, nx, ny, caddress;
+	float gradv;
 	Particle * parts;
 	Element *elements;
 	if(!sim)
@@ -1209,7 +1421,8 @@ void Renderer::render_parts()
 	parts = sim->parts;
 	elements = sim->elements.data();
 #ifdef OGLR
-	float fnx, fny;
+	int orbd[4] = {0, 0, 0, 0}, orbl[4] = {0, 0, 0, 0};
+	float fnx, fny, flicker;
 	int cfireV = 0, cfireC = 0, cfire = 0;
 	int csmokeV = 0, csmokeC = 0, csmoke = 0;
 	int cblobV = 0, cblobC = 0, cblob = 0;
@@ -1227,17 +1440,7 @@ void Renderer::render_parts()
 	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, partsFbo);
 	glTranslated(0, MENUSIZE, 0);
 #else
-	if (gridSize)//draws the grid
-	{
-		for (ny=0; ny<YRES; ny++)
-			for (nx=0; nx<XRES; nx++)
-			{
-				if (ny%(4*gridSize) == 0)
-					blendpixel(nx, ny, 100, 100, 100, 80);
-				if (nx%(4*gridSize) == 0 && ny%(4*gridSize) != 0)
-					blendpixel(nx, ny, 100, 100, 100, 80);
-			}
-	}
+	renderedParts.clear();
 #endif
 	foundElements = 0;
 	for(i = 0; i<=sim->parts_lastActiveIndex; i++) {
@@ -1480,6 +1683,7 @@ void Renderer::render_parts()
 				}
 
 				//Pixel rendering
+#ifdef OGLR
 				if (pixel_mode & EFFECT_LINES)
 				{
 					if (t==PT_SOAP)
@@ -1534,7 +1738,6 @@ void Renderer::render_parts()
 						}
 					}
 
-#ifdef OGLR
 					glColor4f(((float)colr)/255.0f, ((float)colg)/255.0f, ((float)colb)/255.0f, 1.0f);
 					glBegin(GL_LINE_STRIP);
 					if(t==PT_FIGH)
@@ -1576,87 +1779,9 @@ void Renderer::render_parts()
 					glVertex2f(cplayer->legs[8], cplayer->legs[9]);
 					glVertex2f(cplayer->legs[12], cplayer->legs[13]);
 					glEnd();
-#else
-					if (findingElement && findingElement == t)
-					{
-						legr = 255;
-						legg = legb = 0;
-					}
-					else if (colour_mode==COLOUR_HEAT)
-					{
-						legr = colr;
-						legg = colg;
-						legb = colb;
-					}
-					else if (t==PT_STKM2)
-					{
-						legr = 100;
-						legg = 100;
-						legb = 255;
-					}
-					else
-					{
-						legr = 255;
-						legg = 255;
-						legb = 255;
-					}
-
-					if (findingElement && findingElement != t)
-					{
-						colr /= 10;
-						colg /= 10;
-						colb /= 10;
-						legr /= 10;
-						legg /= 10;
-						legb /= 10;
-					}
-
-					//head
-					if(t==PT_FIGH)
-					{
-						draw_line(nx, ny+2, nx+2, ny, colr, colg, colb, 255);
-						draw_line(nx+2, ny, nx, ny-2, colr, colg, colb, 255);
-						draw_line(nx, ny-2, nx-2, ny, colr, colg, colb, 255);
-						draw_line(nx-2, ny, nx, ny+2, colr, colg, colb, 255);
-					}
-					else
-					{
-						draw_line(nx-2, ny+2, nx+2, ny+2, colr, colg, colb, 255);
-						draw_line(nx-2, ny-2, nx+2, ny-2, colr, colg, colb, 255);
-						draw_line(nx-2, ny-2, nx-2, ny+2, colr, colg, colb, 255);
-						draw_line(nx+2, ny-2, nx+2, ny+2, colr, colg, colb, 255);
-					}
-					//legs
-					draw_line(nx, ny+3, int(cplayer->legs[0]), int(cplayer->legs[1]), legr, legg, legb, 255);
-					draw_line(int(cplayer->legs[0]), int(cplayer->legs[1]), int(cplayer->legs[4]), int(cplayer->legs[5]), legr, legg, legb, 255);
-					draw_line(nx, ny+3, int(cplayer->legs[8]), int(cplayer->legs[9]), legr, legg, legb, 255);
-					draw_line(int(cplayer->legs[8]), int(cplayer->legs[9]), int(cplayer->legs[12]), int(cplayer->legs[13]), legr, legg, legb, 255);
-					if (cplayer->rocketBoots)
-					{
-						for (int leg=0; leg<2; leg++)
-						{
-							int nx = int(cplayer->legs[leg*8+4]), ny = int(cplayer->legs[leg*8+5]);
-							int colr = 255, colg = 0, colb = 255;
-							if (((int)(cplayer->comm)&0x04) == 0x04 || (((int)(cplayer->comm)&0x01) == 0x01 && leg==0) || (((int)(cplayer->comm)&0x02) == 0x02 && leg==1))
-								blendpixel(nx, ny, 0, 255, 0, 255);
-							else
-								blendpixel(nx, ny, 255, 0, 0, 255);
-							blendpixel(nx+1, ny, colr, colg, colb, 223);
-							blendpixel(nx-1, ny, colr, colg, colb, 223);
-							blendpixel(nx, ny+1, colr, colg, colb, 223);
-							blendpixel(nx, ny-1, colr, colg, colb, 223);
-
-							blendpixel(nx+1, ny-1, colr, colg, colb, 112);
-							blendpixel(nx-1, ny-1, colr, colg, colb, 112);
-							blendpixel(nx+1, ny+1, colr, colg, colb, 112);
-							blendpixel(nx-1, ny+1, colr, colg, colb, 112);
-						}
-					}
-#endif
 				}
 				if(pixel_mode & PMODE_FLAT)
 				{
-#ifdef OGLR
 					flatV[cflatV++] = nx;
 					flatV[cflatV++] = ny;
 					flatC[cflatC++] = ((float)colr)/255.0f;
@@ -1664,13 +1789,9 @@ void Renderer::render_parts()
 					flatC[cflatC++] = ((float)colb)/255.0f;
 					flatC[cflatC++] = 1.0f;
 					cflat++;
-#else
-					vid[ny*(VIDXRES)+nx] = PIXRGB(colr,colg,colb);
-#endif
 				}
 				if(pixel_mode & PMODE_BLEND)
 				{
-#ifdef OGLR
 					flatV[cflatV++] = nx;
 					flatV[cflatV++] = ny;
 					flatC[cflatC++] = ((float)colr)/255.0f;
@@ -1678,13 +1799,9 @@ void Renderer::render_parts()
 					flatC[cflatC++] = ((float)colb)/255.0f;
 					flatC[cflatC++] = ((float)cola)/255.0f;
 					cflat++;
-#else
-					blendpixel(nx, ny, colr, colg, colb, cola);
-#endif
 				}
 				if(pixel_mode & PMODE_ADD)
 				{
-#ifdef OGLR
 					addV[caddV++] = nx;
 					addV[caddV++] = ny;
 					addC[caddC++] = ((float)colr)/255.0f;
@@ -1692,13 +1809,9 @@ void Renderer::render_parts()
 					addC[caddC++] = ((float)colb)/255.0f;
 					addC[caddC++] = ((float)cola)/255.0f;
 					cadd++;
-#else
-					addpixel(nx, ny, colr, colg, colb, cola);
-#endif
 				}
 				if(pixel_mode & PMODE_BLOB)
 				{
-#ifdef OGLR
 					blobV[cblobV++] = nx;
 					blobV[cblobV++] = ny;
 					blobC[cblobC++] = ((float)colr)/255.0f;
@@ -1706,24 +1819,10 @@ void Renderer::render_parts()
 					blobC[cblobC++] = ((float)colb)/255.0f;
 					blobC[cblobC++] = 1.0f;
 					cblob++;
-#else
-					vid[ny*(VIDXRES)+nx] = PIXRGB(colr,colg,colb);
-
-					blendpixel(nx+1, ny, colr, colg, colb, 223);
-					blendpixel(nx-1, ny, colr, colg, colb, 223);
-					blendpixel(nx, ny+1, colr, colg, colb, 223);
-					blendpixel(nx, ny-1, colr, colg, colb, 223);
-
-					blendpixel(nx+1, ny-1, colr, colg, colb, 112);
-					blendpixel(nx-1, ny-1, colr, colg, colb, 112);
-					blendpixel(nx+1, ny+1, colr, colg, colb, 112);
-					blendpixel(nx-1, ny+1, colr, colg, colb, 112);
-#endif
 				}
 				if(pixel_mode & PMODE_GLOW)
 				{
 					int cola1 = (5*cola)/255;
-#ifdef OGLR
 					glowV[cglowV++] = nx;
 					glowV[cglowV++] = ny;
 					glowC[cglowC++] = ((float)colr)/255.0f;
@@ -1731,32 +1830,9 @@ void Renderer::render_parts()
 					glowC[cglowC++] = ((float)colb)/255.0f;
 					glowC[cglowC++] = 1.0f;
 					cglow++;
-#else
-					addpixel(nx, ny, colr, colg, colb, (192*cola)/255);
-					addpixel(nx+1, ny, colr, colg, colb, (96*cola)/255);
-					addpixel(nx-1, ny, colr, colg, colb, (96*cola)/255);
-					addpixel(nx, ny+1, colr, colg, colb, (96*cola)/255);
-					addpixel(nx, ny-1, colr, colg, colb, (96*cola)/255);
-
-					for (x = 1; x < 6; x++) {
-						addpixel(nx, ny-x, colr, colg, colb, cola1);
-						addpixel(nx, ny+x, colr, colg, colb, cola1);
-						addpixel(nx-x, ny, colr, colg, colb, cola1);
-						addpixel(nx+x, ny, colr, colg, colb, cola1);
-						for (y = 1; y < 6; y++) {
-							if(x + y > 7)
-								continue;
-							addpixel(nx+x, ny-y, colr, colg, colb, cola1);
-							addpixel(nx-x, ny+y, colr, colg, colb, cola1);
-							addpixel(nx+x, ny+y, colr, colg, colb, cola1);
-							addpixel(nx-x, ny-y, colr, colg, colb, cola1);
-						}
-					}
-#endif
 				}
 				if(pixel_mode & PMODE_BLUR)
 				{
-#ifdef OGLR
 					blurV[cblurV++] = nx;
 					blurV[cblurV++] = ny;
 					blurC[cblurC++] = ((float)colr)/255.0f;
@@ -1764,25 +1840,10 @@ void Renderer::render_parts()
 					blurC[cblurC++] = ((float)colb)/255.0f;
 					blurC[cblurC++] = 1.0f;
 					cblur++;
-#else
-					for (x=-3; x<4; x++)
-					{
-						for (y=-3; y<4; y++)
-						{
-							if (abs(x)+abs(y) <2 && !(abs(x)==2||abs(y)==2))
-								blendpixel(x+nx, y+ny, colr, colg, colb, 30);
-							if (abs(x)+abs(y) <=3 && abs(x)+abs(y))
-								blendpixel(x+nx, y+ny, colr, colg, colb, 20);
-							if (abs(x)+abs(y) == 2)
-								blendpixel(x+nx, y+ny, colr, colg, colb, 10);
-						}
-					}
-#endif
 				}
 				if(pixel_mode & PMODE_SPARK)
 				{
-					flicker = float(random_gen()%20);
-#ifdef OGLR
+					flicker = float(rng()%20);
 					//Oh god, this is awful
 					lineC[clineC++] = ((float)colr)/255.0f;
 					lineC[clineC++] = ((float)colg)/255.0f;
@@ -1831,22 +1892,10 @@ void Renderer::render_parts()
 					lineV[clineV++] = fnx;
 					lineV[clineV++] = fny+5;
 					cline++;
-#else
-					gradv = 4*sim->parts[i].life + flicker;
-					for (x = 0; gradv>0.5; x++) {
-						addpixel(nx+x, ny, colr, colg, colb, int(gradv));
-						addpixel(nx-x, ny, colr, colg, colb, int(gradv));
-
-						addpixel(nx, ny+x, colr, colg, colb, int(gradv));
-						addpixel(nx, ny-x, colr, colg, colb, int(gradv));
-						gradv = gradv/1.5f;
-					}
-#endif
 				}
 				if(pixel_mode & PMODE_FLARE)
 				{
-					flicker = float(random_gen()%20);
-#ifdef OGLR
+					flicker = float(rng()%20);
 					//Oh god, this is awful
 					lineC[clineC++] = ((float)colr)/255.0f;
 					lineC[clineC++] = ((float)colg)/255.0f;
@@ -1895,31 +1944,10 @@ void Renderer::render_parts()
 					lineV[clineV++] = fnx;
 					lineV[clineV++] = fny+10;
 					cline++;
-#else
-					gradv = flicker + fabs(parts[i].vx)*17 + fabs(sim->parts[i].vy)*17;
-					blendpixel(nx, ny, colr, colg, colb, int((gradv*4)>255?255:(gradv*4)) );
-					blendpixel(nx+1, ny, colr, colg, colb,int( (gradv*2)>255?255:(gradv*2)) );
-					blendpixel(nx-1, ny, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
-					blendpixel(nx, ny+1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
-					blendpixel(nx, ny-1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
-					if (gradv>255) gradv=255;
-					blendpixel(nx+1, ny-1, colr, colg, colb, int(gradv));
-					blendpixel(nx-1, ny-1, colr, colg, colb, int(gradv));
-					blendpixel(nx+1, ny+1, colr, colg, colb, int(gradv));
-					blendpixel(nx-1, ny+1, colr, colg, colb, int(gradv));
-					for (x = 1; gradv>0.5; x++) {
-						addpixel(nx+x, ny, colr, colg, colb, int(gradv));
-						addpixel(nx-x, ny, colr, colg, colb, int(gradv));
-						addpixel(nx, ny+x, colr, colg, colb, int(gradv));
-						addpixel(nx, ny-x, colr, colg, colb, int(gradv));
-						gradv = gradv/1.2f;
-					}
-#endif
 				}
 				if(pixel_mode & PMODE_LFLARE)
 				{
-					flicker = float(random_gen()%20);
-#ifdef OGLR
+					flicker = float(rng()%20);
 					//Oh god, this is awful
 					lineC[clineC++] = ((float)colr)/255.0f;
 					lineC[clineC++] = ((float)colg)/255.0f;
@@ -1968,26 +1996,6 @@ void Renderer::render_parts()
 					lineV[clineV++] = fnx;
 					lineV[clineV++] = fny+70;
 					cline++;
-#else
-					gradv = flicker + fabs(parts[i].vx)*17 + fabs(parts[i].vy)*17;
-					blendpixel(nx, ny, colr, colg, colb, int((gradv*4)>255?255:(gradv*4)) );
-					blendpixel(nx+1, ny, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
-					blendpixel(nx-1, ny, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
-					blendpixel(nx, ny+1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
-					blendpixel(nx, ny-1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
-					if (gradv>255) gradv=255;
-					blendpixel(nx+1, ny-1, colr, colg, colb, int(gradv));
-					blendpixel(nx-1, ny-1, colr, colg, colb, int(gradv));
-					blendpixel(nx+1, ny+1, colr, colg, colb, int(gradv));
-					blendpixel(nx-1, ny+1, colr, colg, colb, int(gradv));
-					for (x = 1; gradv>0.5; x++) {
-						addpixel(nx+x, ny, colr, colg, colb, int(gradv));
-						addpixel(nx-x, ny, colr, colg, colb, int(gradv));
-						addpixel(nx, ny+x, colr, colg, colb, int(gradv));
-						addpixel(nx, ny-x, colr, colg, colb, int(gradv));
-						gradv = gradv/1.01f;
-					}
-#endif
 				}
 				if (pixel_mode & EFFECT_GRAVIN)
 				{
@@ -2047,7 +2055,6 @@ void Renderer::render_parts()
 				//Fire effects
 				if(firea && (pixel_mode & FIRE_BLEND))
 				{
-#ifdef OGLR
 					smokeV[csmokeV++] = nx;
 					smokeV[csmokeV++] = ny;
 					smokeC[csmokeC++] = ((float)firer)/255.0f;
@@ -2055,16 +2062,9 @@ void Renderer::render_parts()
 					smokeC[csmokeC++] = ((float)fireb)/255.0f;
 					smokeC[csmokeC++] = ((float)firea)/255.0f;
 					csmoke++;
-#else
-					firea /= 2;
-					fire_r[ny/CELL][nx/CELL] = (firea*firer + (255-firea)*fire_r[ny/CELL][nx/CELL]) >> 8;
-					fire_g[ny/CELL][nx/CELL] = (firea*fireg + (255-firea)*fire_g[ny/CELL][nx/CELL]) >> 8;
-					fire_b[ny/CELL][nx/CELL] = (firea*fireb + (255-firea)*fire_b[ny/CELL][nx/CELL]) >> 8;
-#endif
 				}
 				if(firea && (pixel_mode & FIRE_ADD))
 				{
-#ifdef OGLR
 					fireV[cfireV++] = nx;
 					fireV[cfireV++] = ny;
 					fireC[cfireC++] = ((float)firer)/255.0f;
@@ -2072,7 +2072,96 @@ void Renderer::render_parts()
 					fireC[cfireC++] = ((float)fireb)/255.0f;
 					fireC[cfireC++] = ((float)firea)/255.0f;
 					cfire++;
+				}
+				if(firea && (pixel_mode & FIRE_SPARK))
+				{
+					smokeV[csmokeV++] = nx;
+					smokeV[csmokeV++] = ny;
+					smokeC[csmokeC++] = ((float)firer)/255.0f;
+					smokeC[csmokeC++] = ((float)fireg)/255.0f;
+					smokeC[csmokeC++] = ((float)fireb)/255.0f;
+					smokeC[csmokeC++] = ((float)firea)/255.0f;
+					csmoke++;
+				}
 #else
+				if ((pixel_mode & PSPEC_STICKMAN) && !(t == PT_STKM || t == PT_STKM2 || (t == PT_FIGH && parts[i].tmp >= 0 && parts[i].tmp < MAX_FIGHTERS)))
+				{
+					// no player to draw this with, nothing past its lines gets drawn
+					pixel_mode &= EFFECT_LINES;
+					firea = 0;
+				}
+
+				RenderedPart part = {};
+				part.i = i;
+				part.nx = nx;
+				part.ny = ny;
+				part.pixel_mode = pixel_mode;
+				part.colr = colr;
+				part.colg = colg;
+				part.colb = colb;
+				part.cola = cola;
+
+				// pixels around (nx, ny) that draw_part may touch, used to pick the bands the particle is drawn in
+				// and the blocks it's redrawn in
+				int reach = 1;
+				if (pixel_mode & PMODE_BLUR)
+					reach = 3;
+				if (pixel_mode & PMODE_GLOW)
+					reach = 5;
+				if (pixel_mode & (EFFECT_GRAVIN | EFFECT_GRAVOUT))
+					reach = std::max(reach, 16);
+				// rng is called here rather than in draw_part so that it is called in particle order
+				if (pixel_mode & PMODE_SPARK)
+				{
+					part.sparkFlicker = rng()%20;
+					reach = std::max(reach, flareReach(4*parts[i].life + float(part.sparkFlicker), 1.5f));
+				}
+				if (pixel_mode & PMODE_FLARE)
+				{
+					part.flareFlicker = rng()%20;
+					gradv = part.flareFlicker + fabs(parts[i].vx)*17 + fabs(parts[i].vy)*17;
+					reach = std::max(reach, flareReach(std::min(gradv, 255.0f), 1.2f));
+				}
+				if (pixel_mode & PMODE_LFLARE)
+				{
+					part.lflareFlicker = rng()%20;
+					gradv = part.lflareFlicker + fabs(parts[i].vx)*17 + fabs(parts[i].vy)*17;
+					reach = std::max(reach, flareReach(std::min(gradv, 255.0f), 1.01f));
+				}
+				int left = nx - reach, top = ny - reach, right = nx + reach + 1, bottom = ny + reach + 1;
+				if ((pixel_mode & EFFECT_LINES) && t == PT_SOAP && (parts[i].ctype&3) == 3 && parts[i].tmp >= 0 && parts[i].tmp < NPART)
+				{
+					int otherX = (int)(parts[parts[i].tmp].x+0.5f);
+					int otherY = (int)(parts[parts[i].tmp].y+0.5f);
+					left = std::min(left, otherX);
+					top = std::min(top, otherY);
+					right = std::max(right, otherX + 1);
+					bottom = std::max(bottom, otherY + 1);
+				}
+				if ((pixel_mode & PSPEC_STICKMAN) || ((pixel_mode & EFFECT_DBGLINES) && debugLines))
+				{
+					// legs, the health shown next to the mouse and debug lines can go anywhere
+					left = 0;
+					top = 0;
+					right = VIDXRES;
+					bottom = VIDYRES;
+				}
+				part.left = std::max(left, 0);
+				part.top = std::max(top, 0);
+				part.right = std::min(right, VIDXRES);
+				part.bottom = std::min(bottom, VIDYRES);
+				renderedParts.push_back(part);
+
+				//Fire effects, these only go into the fire maps so they are applied right away
+				if(firea && (pixel_mode & FIRE_BLEND))
+				{
+					firea /= 2;
+					fire_r[ny/CELL][nx/CELL] = (firea*firer + (255-firea)*fire_r[ny/CELL][nx/CELL]) >> 8;
+					fire_g[ny/CELL][nx/CELL] = (firea*fireg + (255-firea)*fire_g[ny/CELL][nx/CELL]) >> 8;
+					fire_b[ny/CELL][nx/CELL] = (firea*fireb + (255-firea)*fire_b[ny/CELL][nx/CELL]) >> 8;
+				}
+				if(firea && (pixel_mode & FIRE_ADD))
+				{
 					firea /= 8;
 					firer = ((firea*firer) >> 8) + fire_r[ny/CELL][nx/CELL];
 					fireg = ((firea*fireg) >> 8) + fire_g[ny/CELL][nx/CELL];
@@ -2088,25 +2177,15 @@ void Renderer::render_parts()
 					fire_r[ny/CELL][nx/CELL] = firer;
 					fire_g[ny/CELL][nx/CELL] = fireg;
 					fire_b[ny/CELL][nx/CELL] = fireb;
-#endif
 				}
 				if(firea && (pixel_mode & FIRE_SPARK))
 				{
-#ifdef OGLR
-					smokeV[csmokeV++] = nx;
-					smokeV[csmokeV++] = ny;
-					smokeC[csmokeC++] = ((float)firer)/255.0f;
-					smokeC[csmokeC++] = ((float)fireg)/255.0f;
-					smokeC[csmokeC++] = ((float)fireb)/255.0f;
-					smokeC[csmokeC++] = ((float)firea)/255.0f;
-					csmoke++;
-#else
 					firea /= 4;
 					fire_r[ny/CELL][nx/CELL] = (firea*firer + (255-firea)*fire_r[ny/CELL][nx/CELL]) >> 8;
 					fire_g[ny/CELL][nx/CELL] = (firea*fireg + (255-firea)*fire_g[ny/CELL][nx/CELL]) >> 8;
 					fire_b[ny/CELL][nx/CELL] = (firea*fireb + (255-firea)*fire_b[ny/CELL][nx/CELL]) >> 8;
-#endif
 				}
+#endif
 			}
 		}
 	}
@@ -2292,9 +2371,570 @@ void Renderer::render_parts()
 #endif
 }
 
+#ifndef OGLR
+void Renderer::draw_parts()
+{
+	// Each band of rows is drawn by a single thread, replaying the particles that reach into it in
+	// order, so every pixel goes through the same writes in the same order as when all of them are
+	// drawn one after the other
+	if (ThreadPool::Ref().ThreadCount() == 1)
+	{
+		for (auto &part : renderedParts)
+			draw_part(part, 0, 0, VIDXRES, VIDYRES);
+	}
+	else
+	{
+		int bandCount = std::min(ThreadPool::Ref().ThreadCount() * 4, VIDYRES / 16);
+		int bandHeight = (VIDYRES + bandCount - 1) / bandCount;
+		renderedBands.resize(bandCount);
+		for (auto &band : renderedBands)
+			band.clear();
+		for (int k = 0; k < int(renderedParts.size()); k++)
+			for (int band = renderedParts[k].top / bandHeight; band <= (renderedParts[k].bottom - 1) / bandHeight; band++)
+				renderedBands[band].push_back(k);
+		ThreadPool::Ref().ParallelFor(0, bandCount, 1, [this, bandHeight](int bandBegin, int bandEnd) {
+			for (int band = bandBegin; band < bandEnd; band++)
+				for (auto k : renderedBands[band])
+					draw_part(renderedParts[k], 0, band * bandHeight, VIDXRES, std::min((band + 1) * bandHeight, VIDYRES));
+		});
+	}
+}
+
+void Renderer::draw_part(const RenderedPart &part, int left, int top, int right, int bottom)
+{
+	ClippedPixels pixels(vid, left, top, right, bottom);
+	Particle *parts = sim->parts;
+	Element *elements = sim->elements.data();
+	int orbd[4] = {0, 0, 0, 0}, orbl[4] = {0, 0, 0, 0};
+	int i = part.i, t = parts[i].type, nx = part.nx, ny = part.ny, pixel_mode = part.pixel_mode, x, y;
+	int colr = part.colr, colg = part.colg, colb = part.colb, cola = part.cola;
+	float gradv;
+
+	if (pixel_mode & EFFECT_LINES)
+	{
+		if (t==PT_SOAP)
+		{
+			if ((parts[i].ctype&3) == 3 && parts[i].tmp >= 0 && parts[i].tmp < NPART)
+				pixels.draw_line(nx, ny, (int)(parts[parts[i].tmp].x+0.5f), (int)(parts[parts[i].tmp].y+0.5f), colr, colg, colb, cola);
+		}
+	}
+	if(pixel_mode & PSPEC_STICKMAN)
+	{
+		int legr, legg, legb;
+		playerst *cplayer;
+		if(t==PT_STKM)
+			cplayer = &sim->player;
+		else if(t==PT_STKM2)
+			cplayer = &sim->player2;
+		else
+			cplayer = &sim->fighters[(unsigned char)sim->parts[i].tmp];
+
+		if (mousePos.X>(nx-3) && mousePos.X<(nx+3) && mousePos.Y<(ny+3) && mousePos.Y>(ny-3)) //If mouse is in the head
+		{
+			String hp = String::Build(Format::Width(sim->parts[i].life, 3));
+			pixels.drawtext(mousePos.X-8-2*(sim->parts[i].life<100)-2*(sim->parts[i].life<10), mousePos.Y-12, hp, 255, 255, 255, 255);
+		}
+
+		if (findingElement == t)
+		{
+			colr = 255;
+			colg = colb = 0;
+		}
+		else if (colour_mode != COLOUR_HEAT)
+		{
+			if (cplayer->fan)
+			{
+				colr = PIXR(0x8080FF);
+				colg = PIXG(0x8080FF);
+				colb = PIXB(0x8080FF);
+			}
+			else if (cplayer->elem < PT_NUM && cplayer->elem > 0)
+			{
+				colr = PIXR(elements[cplayer->elem].Colour);
+				colg = PIXG(elements[cplayer->elem].Colour);
+				colb = PIXB(elements[cplayer->elem].Colour);
+			}
+			else
+			{
+				colr = 0x80;
+				colg = 0x80;
+				colb = 0xFF;
+			}
+		}
+
+		if (findingElement && findingElement == t)
+		{
+			legr = 255;
+			legg = legb = 0;
+		}
+		else if (colour_mode==COLOUR_HEAT)
+		{
+			legr = colr;
+			legg = colg;
+			legb = colb;
+		}
+		else if (t==PT_STKM2)
+		{
+			legr = 100;
+			legg = 100;
+			legb = 255;
+		}
+		else
+		{
+			legr = 255;
+			legg = 255;
+			legb = 255;
+		}
+
+		if (findingElement && findingElement != t)
+		{
+			colr /= 10;
+			colg /= 10;
+			colb /= 10;
+			legr /= 10;
+			legg /= 10;
+			legb /= 10;
+		}
+
+		//head
+		if(t==PT_FIGH)
+		{
+			pixels.draw_line(nx, ny+2, nx+2, ny, colr, colg, colb, 255);
+			pixels.draw_line(nx+2, ny, nx, ny-2, colr, colg, colb, 255);
+			pixels.draw_line(nx, ny-2, nx-2, ny, colr, colg, colb, 255);
+			pixels.draw_line(nx-2, ny, nx, ny+2, colr, colg, colb, 255);
+		}
+		else
+		{
+			pixels.draw_line(nx-2, ny+2, nx+2, ny+2, colr, colg, colb, 255);
+			pixels.draw_line(nx-2, ny-2, nx+2, ny-2, colr, colg, colb, 255);
+			pixels.draw_line(nx-2, ny-2, nx-2, ny+2, colr, colg, colb, 255);
+			pixels.draw_line(nx+2, ny-2, nx+2, ny+2, colr, colg, colb, 255);
+		}
+		//legs
+		pixels.draw_line(nx, ny+3, int(cplayer->legs[0]), int(cplayer->legs[1]), legr, legg, legb, 255);
+		pixels.draw_line(int(cplayer->legs[0]), int(cplayer->legs[1]), int(cplayer->legs[4]), int(cplayer->legs[5]), legr, legg, legb, 255);
+		pixels.draw_line(nx, ny+3, int(cplayer->legs[8]), int(cplayer->legs[9]), legr, legg, legb, 255);
+		pixels.draw_line(int(cplayer->legs[8]), int(cplayer->legs[9]), int(cplayer->legs[12]), int(cplayer->legs[13]), legr, legg, legb, 255);
+		if (cplayer->rocketBoots)
+		{
+			for (int leg=0; leg<2; leg++)
+			{
+				int nx = int(cplayer->legs[leg*8+4]), ny = int(cplayer->legs[leg*8+5]);
+				int colr = 255, colg = 0, colb = 255;
+				if (((int)(cplayer->comm)&0x04) == 0x04 || (((int)(cplayer->comm)&0x01) == 0x01 && leg==0) || (((int)(cplayer->comm)&0x02) == 0x02 && leg==1))
+					pixels.blendpixel(nx, ny, 0, 255, 0, 255);
+				else
+					pixels.blendpixel(nx, ny, 255, 0, 0, 255);
+				pixels.blendpixel(nx+1, ny, colr, colg, colb, 223);
+				pixels.blendpixel(nx-1, ny, colr, colg, colb, 223);
+				pixels.blendpixel(nx, ny+1, colr, colg, colb, 223);
+				pixels.blendpixel(nx, ny-1, colr, colg, colb, 223);
+
+				pixels.blendpixel(nx+1, ny-1, colr, colg, colb, 112);
+				pixels.blendpixel(nx-1, ny-1, colr, colg, colb, 112);
+				pixels.blendpixel(nx+1, ny+1, colr, colg, colb, 112);
+				pixels.blendpixel(nx-1, ny+1, colr, colg, colb, 112);
+			}
+		}
+	}
+	if(pixel_mode & PMODE_FLAT)
+	{
+		pixels.setpixel(nx, ny, colr, colg, colb);
+	}
+	if(pixel_mode & PMODE_BLEND)
+	{
+		pixels.blendpixel(nx, ny, colr, colg, colb, cola);
+	}
+	if(pixel_mode & PMODE_ADD)
+	{
+		pixels.addpixel(nx, ny, colr, colg, colb, cola);
+	}
+	if(pixel_mode & PMODE_BLOB)
+	{
+		pixels.setpixel(nx, ny, colr, colg, colb);
+
+		pixels.blendpixel(nx+1, ny, colr, colg, colb, 223);
+		pixels.blendpixel(nx-1, ny, colr, colg, colb, 223);
+		pixels.blendpixel(nx, ny+1, colr, colg, colb, 223);
+		pixels.blendpixel(nx, ny-1, colr, colg, colb, 223);
+
+		pixels.blendpixel(nx+1, ny-1, colr, colg, colb, 112);
+		pixels.blendpixel(nx-1, ny-1, colr, colg, colb, 112);
+		pixels.blendpixel(nx+1, ny+1, colr, colg, colb, 112);
+		pixels.blendpixel(nx-1, ny+1, colr, colg, colb, 112);
+	}
+	if(pixel_mode & PMODE_GLOW)
+	{
+		int cola1 = (5*cola)/255;
+		pixels.addpixel(nx, ny, colr, colg, colb, (192*cola)/255);
+		pixels.addpixel(nx+1, ny, colr, colg, colb, (96*cola)/255);
+		pixels.addpixel(nx-1, ny, colr, colg, colb, (96*cola)/255);
+		pixels.addpixel(nx, ny+1, colr, colg, colb, (96*cola)/255);
+		pixels.addpixel(nx, ny-1, colr, colg, colb, (96*cola)/255);
+
+		for (x = 1; x < 6; x++) {
+			pixels.addpixel(nx, ny-x, colr, colg, colb, cola1);
+			pixels.addpixel(nx, ny+x, colr, colg, colb, cola1);
+			pixels.addpixel(nx-x, ny, colr, colg, colb, cola1);
+			pixels.addpixel(nx+x, ny, colr, colg, colb, cola1);
+			for (y = 1; y < 6; y++) {
+				if(x + y > 7)
+					continue;
+				pixels.addpixel(nx+x, ny-y, colr, colg, colb, cola1);
+				pixels.addpixel(nx-x, ny+y, colr, colg, colb, cola1);
+				pixels.addpixel(nx+x, ny+y, colr, colg, colb, cola1);
+				pixels.addpixel(nx-x, ny-y, colr, colg, colb, cola1);
+			}
+		}
+	}
+	if(pixel_mode & PMODE_BLUR)
+	{
+		for (x=-3; x<4; x++)
+		{
+			for (y=-3; y<4; y++)
+			{
+				if (abs(x)+abs(y) <2 && !(abs(x)==2||abs(y)==2))
+					pixels.blendpixel(x+nx, y+ny, colr, colg, colb, 30);
+				if (abs(x)+abs(y) <=3 && abs(x)+abs(y))
+					pixels.blendpixel(x+nx, y+ny, colr, colg, colb, 20);
+				if (abs(x)+abs(y) == 2)
+					pixels.blendpixel(x+nx, y+ny, colr, colg, colb, 10);
+			}
+		}
+	}
+	if(pixel_mode & PMODE_SPARK)
+	{
+		gradv = 4*sim->parts[i].life + float(part.sparkFlicker);
+		for (x = 0; gradv>0.5; x++) {
+			pixels.addpixel(nx+x, ny, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx-x, ny, colr, colg, colb, int(gradv));
+
+			pixels.addpixel(nx, ny+x, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx, ny-x, colr, colg, colb, int(gradv));
+			gradv = gradv/1.5f;
+		}
+	}
+	if(pixel_mode & PMODE_FLARE)
+	{
+		gradv = float(part.flareFlicker) + fabs(parts[i].vx)*17 + fabs(sim->parts[i].vy)*17;
+		pixels.blendpixel(nx, ny, colr, colg, colb, int((gradv*4)>255?255:(gradv*4)) );
+		pixels.blendpixel(nx+1, ny, colr, colg, colb,int( (gradv*2)>255?255:(gradv*2)) );
+		pixels.blendpixel(nx-1, ny, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
+		pixels.blendpixel(nx, ny+1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
+		pixels.blendpixel(nx, ny-1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
+		if (gradv>255) gradv=255;
+		pixels.blendpixel(nx+1, ny-1, colr, colg, colb, int(gradv));
+		pixels.blendpixel(nx-1, ny-1, colr, colg, colb, int(gradv));
+		pixels.blendpixel(nx+1, ny+1, colr, colg, colb, int(gradv));
+		pixels.blendpixel(nx-1, ny+1, colr, colg, colb, int(gradv));
+		for (x = 1; gradv>0.5; x++) {
+			pixels.addpixel(nx+x, ny, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx-x, ny, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx, ny+x, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx, ny-x, colr, colg, colb, int(gradv));
+			gradv = gradv/1.2f;
+		}
+	}
+	if(pixel_mode & PMODE_LFLARE)
+	{
+		gradv = float(part.lflareFlicker) + fabs(parts[i].vx)*17 + fabs(parts[i].vy)*17;
+		pixels.blendpixel(nx, ny, colr, colg, colb, int((gradv*4)>255?255:(gradv*4)) );
+		pixels.blendpixel(nx+1, ny, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
+		pixels.blendpixel(nx-1, ny, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
+		pixels.blendpixel(nx, ny+1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
+		pixels.blendpixel(nx, ny-1, colr, colg, colb, int((gradv*2)>255?255:(gradv*2)) );
+		if (gradv>255) gradv=255;
+		pixels.blendpixel(nx+1, ny-1, colr, colg, colb, int(gradv));
+		pixels.blendpixel(nx-1, ny-1, colr, colg, colb, int(gradv));
+		pixels.blendpixel(nx+1, ny+1, colr, colg, colb, int(gradv));
+		pixels.blendpixel(nx-1, ny+1, colr, colg, colb, int(gradv));
+		for (x = 1; gradv>0.5; x++) {
+			pixels.addpixel(nx+x, ny, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx-x, ny, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx, ny+x, colr, colg, colb, int(gradv));
+			pixels.addpixel(nx, ny-x, colr, colg, colb, int(gradv));
+			gradv = gradv/1.01f;
+		}
+	}
+	if (pixel_mode & EFFECT_GRAVIN)
+	{
+		int nxo = 0;
+		int nyo = 0;
+		int r;
+		float drad = 0.0f;
+		float ddist = 0.0f;
+		sim->orbitalparts_get(parts[i].life, parts[i].ctype, orbd, orbl);
+		for (r = 0; r < 4; r++) {
+			ddist = ((float)orbd[r])/16.0f;
+			drad = (M_PI * ((float)orbl[r]) / 180.0f)*1.41f;
+			nxo = (int)(ddist*cos(drad));
+			nyo = (int)(ddist*sin(drad));
+			if (ny+nyo>0 && ny+nyo<YRES && nx+nxo>0 && nx+nxo<XRES && TYP(sim->pmap[ny+nyo][nx+nxo]) != PT_PRTI)
+				pixels.addpixel(nx+nxo, ny+nyo, colr, colg, colb, 255-orbd[r]);
+		}
+	}
+	if (pixel_mode & EFFECT_GRAVOUT)
+	{
+		int nxo = 0;
+		int nyo = 0;
+		int r;
+		float drad = 0.0f;
+		float ddist = 0.0f;
+		sim->orbitalparts_get(parts[i].life, parts[i].ctype, orbd, orbl);
+		for (r = 0; r < 4; r++) {
+			ddist = ((float)orbd[r])/16.0f;
+			drad = (M_PI * ((float)orbl[r]) / 180.0f)*1.41f;
+			nxo = (int)(ddist*cos(drad));
+			nyo = (int)(ddist*sin(drad));
+			if (ny+nyo>0 && ny+nyo<YRES && nx+nxo>0 && nx+nxo<XRES && TYP(sim->pmap[ny+nyo][nx+nxo]) != PT_PRTO)
+				pixels.addpixel(nx+nxo, ny+nyo, colr, colg, colb, 255-orbd[r]);
+		}
+	}
+	if (pixel_mode & EFFECT_DBGLINES && !(display_mode&DISPLAY_PERS))
+	{
+		// draw lines connecting wifi/portal channels
+		if (mousePos.X == nx && mousePos.Y == ny && i == ID(sim->pmap[ny][nx]) && debugLines)
+		{
+			int type = parts[i].type, tmp = (int)((parts[i].temp-73.15f)/100+1), othertmp;
+			if (type == PT_PRTI)
+				type = PT_PRTO;
+			else if (type == PT_PRTO)
+				type = PT_PRTI;
+			for (int z = 0; z <= sim->parts_lastActiveIndex; z++)
+			{
+				if (parts[z].type == type)
+				{
+					othertmp = (int)((parts[z].temp-73.15f)/100+1);
+					if (tmp == othertmp)
+						pixels.xor_line(nx,ny,(int)(parts[z].x+0.5f),(int)(parts[z].y+0.5f));
+				}
+			}
+		}
+	}
+}
+
+// For the hashes render_retained compares from one frame to the next
+static uint64_t HashMix(uint64_t hash, uint64_t value)
+{
+	hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+	return hash ^ (hash >> 32);
+}
+
+static uint64_t FloatBits(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+// RenderBegin with retainFrame set. The frame is split into CELL sized blocks and each gets a hash
+// of everything that goes into it: the wall in it, the particles that reach into it as
+// record_parts worked them out, in the order they are drawn, the fire maps around it and the
+// signs over it. Blocks with the same hash as in the last frame are copied from retainedVid, the
+// rest are cleared and drawn again, each drawing clipped to them, which gives the same pixels as
+// drawing the whole frame. Air, gravity and EMP displays, streamlines, blobs and stickmen draw
+// over more than they can be hashed into, so with any of them the whole frame is drawn instead,
+// as it is when most of the blocks changed anyway.
+void Renderer::render_retained()
+{
+	const int blocksX = (VIDXRES+CELL-1)/CELL, blocksY = (VIDYRES+CELL-1)/CELL;
+
+	// the fire maps are drawn from after DrawWalls and render_parts have added to them
+	for (int y = 0; y < YRES/CELL; y++)
+		for (int x = 0; x < XRES/CELL; x++)
+			if (sim->bmap[y][x] && sim->bmap[y][x] < UI_WALLCOUNT)
+				glow_wall(x, y);
+	record_parts();
+
+	bool hashable = !(display_mode & DISPLAY_AIR) && !gravityFieldEnabled && !gravityZonesEnabled && !(render_mode & PMODE_BLOB) && !((render_mode & EFFECT) && sim->emp_decor > 0);
+	uint64_t settings = 0;
+	for (uint64_t value : { uint64_t(render_mode), uint64_t(colour_mode), uint64_t(display_mode), uint64_t(decorations_enable), uint64_t(blackDecorations), uint64_t(findingElement), uint64_t(gridSize), uint64_t(debugLines), uint64_t(uintptr_t(vid)) })
+		settings = HashMix(settings, value);
+	for (auto &row : fire_alpha)
+		for (auto alpha : row)
+			settings = HashMix(settings, alpha);
+
+	blockHashes.assign(blocksX*blocksY, 0);
+	auto hashInto = [this, blocksX](int left, int top, int right, int bottom, uint64_t hash) {
+		if (right <= 0 || bottom <= 0)
+			return;
+		for (int by = std::max(top, 0)/CELL; by <= (std::min(bottom, VIDYRES)-1)/CELL; by++)
+			for (int bx = std::max(left, 0)/CELL; bx <= (std::min(right, VIDXRES)-1)/CELL; bx++)
+				blockHashes[by*blocksX+bx] = HashMix(blockHashes[by*blocksX+bx], hash);
+	};
+	for (int y = 0; y < YRES/CELL; y++)
+		for (int x = 0; x < XRES/CELL; x++)
+			if (sim->bmap[y][x] && sim->bmap[y][x] < UI_WALLCOUNT)
+			{
+				if (sim->bmap[y][x] == WL_STREAM)
+					hashable = false;
+				blockHashes[y*blocksX+x] = HashMix(0, sim->bmap[y][x] | sim->emap[y][x] << 8 | 1 << 16);
+			}
+	for (auto &part : renderedParts)
+	{
+		if ((part.pixel_mode & PSPEC_STICKMAN) || ((part.pixel_mode & EFFECT_DBGLINES) && debugLines))
+			hashable = false;
+		uint64_t hash = HashMix(0, uint64_t(part.i) | uint64_t(uint32_t(part.pixel_mode)) << 32);
+		hash = HashMix(hash, uint64_t(uint16_t(part.nx)) | uint64_t(uint16_t(part.ny)) << 16 | uint64_t(part.colr) << 32 | uint64_t(part.colg) << 40 | uint64_t(part.colb) << 48 | uint64_t(part.cola) << 56);
+		hash = HashMix(hash, part.sparkFlicker | part.flareFlicker << 8 | part.lflareFlicker << 16);
+		if (part.pixel_mode & (EFFECT_LINES | PMODE_SPARK | PMODE_FLARE | PMODE_LFLARE | EFFECT_GRAVIN | EFFECT_GRAVOUT))
+		{
+			// draw_part reads these from the particle itself
+			Particle &p = sim->parts[part.i];
+			hash = HashMix(hash, uint64_t(uint32_t(p.type)) | uint64_t(uint32_t(p.life)) << 32);
+			hash = HashMix(hash, uint64_t(uint32_t(p.ctype)) | uint64_t(uint32_t(p.tmp)) << 32);
+			hash = HashMix(hash, FloatBits(p.vx) | FloatBits(p.vy) << 32);
+			if (p.tmp >= 0 && p.tmp < NPART)
+				hash = HashMix(hash, FloatBits(sim->parts[p.tmp].x) | FloatBits(sim->parts[p.tmp].y) << 32);
+		}
+		hashInto(part.left, part.top, part.right, part.bottom, hash);
+	}
+	if (render_mode & FIREMODE)
+		for (int j = 0; j < YRES/CELL; j++)
+			for (int i = 0; i < XRES/CELL; i++)
+				if (fire_r[j][i] || fire_g[j][i] || fire_b[j][i])
+				{
+					// the blocks are the size of the cells, so the 3x3 cells draw_fire splats this
+					// one over are the blocks around it
+					uint64_t fire = fire_r[j][i] | fire_g[j][i] << 8 | fire_b[j][i] << 16;
+					for (int y = std::max(j-1, 0); y <= std::min(j+1, blocksY-1); y++)
+						for (int x = std::max(i-1, 0); x <= std::min(i+1, blocksX-1); x++)
+							blockHashes[y*blocksX+x] = HashMix(blockHashes[y*blocksX+x], fire | uint64_t((y-j+1)*3+x-i+1) << 24);
+				}
+	// the box of every sign and the bit pointing at where it is, see DrawSigns
+	std::vector<std::array<int, 4>> signAreas;
+	for (auto &currentSign : sim->signs)
+		if (currentSign.text.length())
+		{
+			int x, y, w, h;
+			String text = currentSign.getDisplayText(sim, x, y, w, h);
+			std::array<int, 4> area = { x, y, x+w+1, y+h+int(std::count(text.begin(), text.end(), '\n'))*FONT_H };
+			uint64_t hash = HashMix(HashMix(0, uint64_t(uint32_t(x)) | uint64_t(uint32_t(y)) << 32), uint64_t(uint32_t(w)) | uint64_t(uint32_t(h)) << 32);
+			if (currentSign.ju != sign::None)
+			{
+				int dx = 1 - currentSign.ju;
+				int dy = (currentSign.y > 18) ? -1 : 1;
+				area = { std::min(area[0], currentSign.x + std::min(dx*3, 0)), std::min(area[1], currentSign.y + std::min(dy*3, 0)),
+				         std::max(area[2], currentSign.x + std::max(dx*3, 0) + 1), std::max(area[3], currentSign.y + std::max(dy*3, 0) + 1) };
+				hash = HashMix(hash, uint64_t(uint32_t(currentSign.x)) | uint64_t(uint32_t(currentSign.y)) << 32 | uint64_t(currentSign.ju) << 48);
+			}
+			for (auto c : text)
+				hash = HashMix(hash, c);
+			hashInto(area[0], area[1], area[2], area[3], hash);
+			signAreas.push_back(area);
+		}
+
+	bool partial = hashable && retainedValid && settings == retainedSettings;
+	int dirtyCount = 0;
+	dirtyBlocks.assign(blocksX*blocksY, 0);
+	if (partial)
+	{
+		for (int b = 0; b < blocksX*blocksY; b++)
+			if (blockHashes[b] != retainedBlockHashes[b])
+			{
+				dirtyBlocks[b] = 1;
+				dirtyCount++;
+			}
+	}
+	// signs are drawn whole, so if one is over a changed block, every block under every sign is
+	// drawn again
+	std::vector<int> signBlocks;
+	for (auto &area : signAreas)
+	{
+		if (area[2] <= 0 || area[3] <= 0)
+			continue;
+		for (int by = std::max(area[1], 0)/CELL; by <= (std::min(area[3], VIDYRES)-1)/CELL; by++)
+			for (int bx = std::max(area[0], 0)/CELL; bx <= (std::min(area[2], VIDXRES)-1)/CELL; bx++)
+				signBlocks.push_back(by*blocksX+bx);
+	}
+	bool signsDirty = std::any_of(signBlocks.begin(), signBlocks.end(), [this](int b) {
+		return dirtyBlocks[b];
+	});
+	if (signsDirty)
+		for (auto b : signBlocks)
+		{
+			dirtyCount += !dirtyBlocks[b];
+			dirtyBlocks[b] = 1;
+		}
+	if (dirtyCount*2 > blocksX*blocksY)
+		partial = false;
+
+	if (!partial)
+	{
+		draw_air();
+		draw_grav();
+		for (int y = 0; y < YRES/CELL; y++)
+			for (int x = 0; x < XRES/CELL; x++)
+				if (sim->bmap[y][x] && sim->bmap[y][x] < UI_WALLCOUNT)
+					draw_wall(x, y);
+		draw_grid(0, 0, XRES, YRES);
+		draw_parts();
+		render_fire();
+		draw_other();
+		draw_grav_zones();
+		DrawSigns();
+		retainedVid.assign(vid, vid+VIDXRES*VIDYRES);
+	}
+	else
+	{
+		std::copy(retainedVid.begin(), retainedVid.end(), vid);
+		// runs of changed blocks in a row of them, as { row, left, top, right, bottom } in pixels
+		std::vector<std::array<int, 5>> runs;
+		std::vector<bool> dirtyRows(blocksY);
+		for (int by = 0; by < blocksY; by++)
+			for (int bx = 0; bx < blocksX; bx++)
+				if (dirtyBlocks[by*blocksX+bx])
+				{
+					int runStart = bx;
+					while (bx < blocksX && dirtyBlocks[by*blocksX+bx])
+						bx++;
+					runs.push_back({ by, runStart*CELL, by*CELL, std::min(bx*CELL, VIDXRES), std::min((by+1)*CELL, VIDYRES) });
+					dirtyRows[by] = true;
+				}
+		// the particles that reach into each row of blocks with something to draw
+		renderedBands.resize(blocksY);
+		for (auto &band : renderedBands)
+			band.clear();
+		for (int k = 0; k < int(renderedParts.size()); k++)
+			for (int by = renderedParts[k].top/CELL; by <= (renderedParts[k].bottom-1)/CELL; by++)
+				if (dirtyRows[by])
+					renderedBands[by].push_back(k);
+
+		for (auto &run : runs)
+		{
+			int by = run[0], left = run[1], top = run[2], right = run[3], bottom = run[4];
+			for (int y = top; y < bottom; y++)
+				std::fill(vid+y*VIDXRES+left, vid+y*VIDXRES+right, 0);
+			if (by < YRES/CELL)
+				for (int x = left/CELL; x < std::min(right/CELL, XRES/CELL); x++)
+					if (sim->bmap[by][x] && sim->bmap[by][x] < UI_WALLCOUNT)
+						draw_wall(x, by);
+			draw_grid(left, top, right, bottom);
+			for (auto k : renderedBands[by])
+				if (renderedParts[k].left < right && renderedParts[k].right > left)
+					draw_part(renderedParts[k], left, top, right, bottom);
+			if (render_mode & FIREMODE)
+				draw_fire(left, top, right, bottom);
+		}
+		if (render_mode & FIREMODE)
+			decay_fire();
+		if (signsDirty)
+			DrawSigns();
+		for (auto &run : runs)
+			for (int y = run[2]; y < run[4]; y++)
+				std::copy(vid+y*VIDXRES+run[1], vid+y*VIDXRES+run[3], retainedVid.begin()+y*VIDXRES+run[1]);
+	}
+
+	retainedBlockHashes.swap(blockHashes);
+	retainedSettings = settings;
+	retainedValid = hashable;
+}
+#endif
+
 void Renderer::draw_other() // EMP effect
 {
-	int i, j;
+	int j;
 	int emp_decor = sim->emp_decor;
 	if (emp_decor>40) emp_decor = 40;
 	if (emp_decor<0) emp_decor = 0;
@@ -2331,10 +2971,7 @@ void Renderer::draw_other() // EMP effect
 		if (b>255) g=255;
 		if (a>255) a=255;
 		for (j=0; j<YRES; j++)
-			for (i=0; i<XRES; i++)
-			{
-				blendpixel(i, j, r, g, b, a);
-			}
+			PixelKernels::Blend(vid + j*(VIDXRES), XRES, r, g, b, a);
 #endif
 	}
 }
@@ -2570,6 +3207,7 @@ Renderer::Renderer(Graphics * g, Simulation * sim):
 	decorations_enable(1),
 	blackDecorations(false),
 	debugLines(false),
+	retainFrame(false),
 	sampleColor(0xFFFFFFFF),
 	findingElement(0),
     foundElements(0),
@@ -2592,6 +3230,8 @@ Renderer::Renderer(Graphics * g, Simulation * sim):
 #endif
 	persistentVid = new pixel[VIDXRES*YRES];
 	warpVid = new pixel[VIDXRES*VIDYRES];
+	retainedSettings = 0;
+	retainedValid = false;
 #endif
 
 	memset(fire_r, 0, sizeof(fire_r));
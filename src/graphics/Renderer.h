@@ -2,6 +2,7 @@
 #define RENDERER_H
 #include "Config.h"
 
+#include <cstdint>
 #include <vector>
 #ifdef OGLR
 #include "OpenGLHeaders.h"
@@ -9,6 +10,7 @@
 
 #include "Graphics.h"
 #include "gui/interface/Point.h"
+#include "common/tpt-rand.h"
 
 class RenderPreset;
 class Simulation;
@@ -61,10 +63,17 @@ public:
 	int decorations_enable;
 	bool blackDecorations;
 	bool debugLines;
+	// Set by a caller that clears the screen right before every RenderBegin. RenderBegin then
+	// keeps a copy of the frame it draws and, where it can, only redraws the CELL sized blocks
+	// of it that changed since the last one.
+	bool retainFrame;
 	pixel sampleColor;
 	int findingElement;
 	int foundElements;
 	int bray_life_brightness_threshold;
+	// per-renderer random number generator for flicker and graphics functions, so that
+	// renderers on different threads don't share one
+	RNG rng;
 
 	//Mouse position for debug information
 	ui::Point mousePos;
@@ -167,6 +176,37 @@ public:
 
 private:
 	int gridSize;
+#ifndef OGLR
+	// What render_parts works out about a particle before draw_part draws it
+	struct RenderedPart
+	{
+		int i, pixel_mode;
+		short nx, ny;
+		short left, top, right, bottom; // the pixels draw_part may draw to, right and bottom excluded
+		unsigned char colr, colg, colb, cola;
+		unsigned char sparkFlicker, flareFlicker, lflareFlicker;
+	};
+	std::vector<RenderedPart> renderedParts;
+	// indices into renderedParts of the particles that reach into each band of rows
+	std::vector<std::vector<int>> renderedBands;
+	void record_parts();
+	void draw_parts();
+	void draw_part(const RenderedPart &part, int left, int top, int right, int bottom);
+	void draw_grid(int left, int top, int right, int bottom);
+	void draw_wall(int x, int y);
+	void glow_wall(int x, int y);
+	void draw_fire(int left, int top, int right, int bottom);
+	void decay_fire();
+
+	// The last frame RenderBegin drew with retainFrame set, and a hash of everything that went
+	// into each CELL sized block of it, see render_retained
+	std::vector<pixel> retainedVid;
+	std::vector<uint64_t> blockHashes, retainedBlockHashes;
+	std::vector<unsigned char> dirtyBlocks;
+	uint64_t retainedSettings;
+	bool retainedValid;
+	void render_retained();
+#endif
 #ifdef OGLR
 	GLuint zoomTex, airBuf, fireAlpha, glowAlpha, blurAlpha, partsFboTex, partsFbo, partsTFX, partsTFY, airPV, airVY, airVX;
 	GLuint fireProg, airProg_Pressure, airProg_Velocity, airProg_Cracker, lensProg;
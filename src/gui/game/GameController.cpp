@@ -14,7 +14,9 @@
 #include "Tool.h"
 
 #ifdef LUACONSOLE
+# include "lua/LuaScriptHelper.h"
 # include "lua/LuaScriptInterface.h"
+# include "lua/LuaSmartRef.h"
 # include "lua/LuaEvents.h"
 #else
 # include "lua/TPTScriptInterface.h"
@@ -28,6 +30,7 @@
 #include "debug/DebugParts.h"
 #include "debug/ElementPopulation.h"
 #include "debug/ParticleDebug.h"
+#include "debug/ProfilerDebug.h"
 #include "graphics/Renderer.h"
 #include "simulation/Air.h"
 #include "simulation/ElementClasses.h"
@@ -84,6 +87,10 @@ GameController::GameController():
 	options(NULL),
 	debugFlags(0),
 	autoreloadEnabled(0),
+	simulationStepPending(false),
+	fastForwarding(false),
+	fastForwardFramesCounted(0),
+	simulationFps(0),
 	HasDone(false)
 {
 	gameView = new GameView();
@@ -107,6 +114,7 @@ GameController::GameController():
 	debugInfo.push_back(new ElementPopulationDebug(0x2, gameModel->GetSimulation()));
 	debugInfo.push_back(new DebugLines(0x4, gameView, this));
 	debugInfo.push_back(new ParticleDebug(0x8, gameModel->GetSimulation(), gameModel, this));
+	debugInfo.push_back(new ProfilerDebug(0x10, gameModel->GetSimulation()));
 }
 
 GameController::~GameController()
@@ -190,7 +198,7 @@ void GameController::HistorySnapshot()
 	// * Calling HistorySnapshot means the user decided to use the current state and
 	//   forfeit the option to go back to whatever they Ctrl+Z'd their way back from.
 	beforeRestore.reset();
-	gameModel->HistoryPush(gameModel->GetSimulation()->CreateSnapshot());
+	gameModel->HistoryPush(gameModel->GetSimulation()->CreateSnapshot(gameModel->HistoryTakeSpare()));
 }
 
 void GameController::HistoryForward()
@@ -919,10 +927,81 @@ void GameController::LoadRenderPreset(int presetNum)
 	ReRenderSave();
 }
 
+void GameController::StepSimulation()
+{
+	Simulation * sim = gameModel->GetSimulation();
+	sim->BeforeSim();
+	if (!sim->sys_pause || sim->framerender)
+	{
+		sim->UpdateParticles(0, NPART);
+		sim->AfterSim();
+		sim->subframe_mode = false;
+	}
+}
+
+bool GameController::CanStepSimulationConcurrently()
+{
+	Simulation * sim = gameModel->GetSimulation();
+	if (!gameModel->GetThreadedSimulation())
+		return false;
+	// particle debugging steps through the simulation and looks at the result right away
+	if (sim->subframe_mode || sim->debug_currentParticle)
+		return false;
+#ifdef LUACONSOLE
+	// element functions written in Lua would run on the simulation thread while graphics
+	// functions written in Lua run on this one, and Lua can only be used from one at a time
+	for (int t = 0; t < PT_NUM; t++)
+	{
+		if (lua_el_mode[t] || lua_gr_func[t])
+			return false;
+	}
+#endif
+	return true;
+}
+
+void GameController::BeginRender()
+{
+	if (!simulationStepPending)
+		return;
+	simulationStepPending = false;
+	Simulation * renderSim = gameModel->GetRenderSimulation();
+	renderSim->CopyRenderState(*gameModel->GetSimulation());
+	gameModel->GetRenderer()->sim = renderSim;
+	simulationStep = std::thread([this]() {
+		StepSimulation();
+	});
+}
+
+void GameController::EndRender()
+{
+	if (simulationStep.joinable())
+	{
+		simulationStep.join();
+		gameModel->GetRenderer()->sim = gameModel->GetSimulation();
+	}
+}
+
+bool GameController::GetFastForward()
+{
+	return fastForwarding;
+}
+
+float GameController::GetSimulationFps()
+{
+	return simulationFps;
+}
+
 void GameController::Update()
 {
 	Simulation * sim = gameModel->GetSimulation();
 
+	if (simulationStepPending)
+	{
+		// nothing was drawn since the last update, so the step never got to run
+		simulationStepPending = false;
+		StepSimulation();
+	}
+
 	if (!sim->sys_pause || sim->framerender)
 	{
 		if (GetAutoreloadEnabled() && sim->needReloadParticleOrder)
@@ -931,12 +1010,45 @@ void GameController::Update()
 		}
 	}
 
-	sim->BeforeSim();
-	if (!sim->sys_pause || sim->framerender)
+	if (gameModel->GetFastForward() && !sim->sys_pause && !sim->subframe_mode && !sim->debug_currentParticle)
 	{
-		sim->UpdateParticles(0, NPART);
-		sim->AfterSim();
-		sim->subframe_mode = false;
+		using Clock = std::chrono::steady_clock;
+		auto start = Clock::now();
+		if (!fastForwarding)
+		{
+			fastForwarding = true;
+			fastForwardFramesCounted = 0;
+			fastForwardCountStart = start;
+			simulationFps = 0;
+		}
+		// step until it's time to draw again; the fps limit only applies to drawn frames
+		int frames = gameModel->GetFastForwardFrames();
+		auto interval = std::chrono::milliseconds(gameModel->GetFastForwardInterval());
+		int steps = 0;
+		do
+		{
+			StepSimulation();
+			steps++;
+		}
+		while ((!frames || steps < frames) && (interval == interval.zero() || Clock::now() - start < interval)
+		       && !sim->sys_pause && sim->debug_breakpointHits.empty());
+
+		fastForwardFramesCounted += steps;
+		auto now = Clock::now();
+		if (now - fastForwardCountStart >= std::chrono::milliseconds(500))
+		{
+			simulationFps = fastForwardFramesCounted / std::chrono::duration<float>(now - fastForwardCountStart).count();
+			fastForwardFramesCounted = 0;
+			fastForwardCountStart = now;
+		}
+	}
+	else
+	{
+		fastForwarding = false;
+		if (CanStepSimulationConcurrently())
+			simulationStepPending = true;
+		else
+			StepSimulation();
 	}
 	if (sim->subframe_mode)
 	{
@@ -946,6 +1058,14 @@ void GameController::Update()
 				((ParticleDebug*)*iter)->UpdateSimUpToInterestingChange();
 		}
 	}
+	if (!sim->debug_breakpointHits.empty())
+	{
+		for (std::vector<DebugInfo*>::iterator iter = debugInfo.begin(), end = debugInfo.end(); iter != end; iter++)
+		{
+			if ((*iter)->debugID == 0x8)
+				((ParticleDebug*)*iter)->LogBreakpointHits();
+		}
+	}
 
 	ui::Point pos = gameView->GetMousePosition();
 	gameModel->GetRenderer()->mousePos = PointTranslate(pos);
@@ -1115,6 +1235,22 @@ bool GameController::GetDebugHUD()
 	return gameView->GetDebugHUD();
 }
 
+void GameController::SetDebugFlags(unsigned int flags)
+{
+	// The profiler overlay turns the profiler on and off with it, starting from zero
+	auto *sim = gameModel->GetSimulation();
+	if ((flags & 0x10) && !(debugFlags & 0x10))
+	{
+		sim->profiler.Reset();
+		sim->profiler.enabled = true;
+	}
+	else if (!(flags & 0x10) && (debugFlags & 0x10))
+	{
+		sim->profiler.enabled = false;
+	}
+	debugFlags = flags;
+}
+
 void GameController::SetActiveColourPreset(int preset)
 {
 	gameModel->SetActiveColourPreset(preset);
@@ -1637,6 +1773,11 @@ bool GameController::AreParticlesInSubframeOrder()
 	return gameModel->AreParticlesInSubframeOrder();
 }
 
+int GameController::GetSubframeOrderBreaks()
+{
+	return gameModel->GetSimulation()->GetSubframeOrderBreaks();
+}
+
 void GameController::Vote(int direction)
 {
 	if(gameModel->GetSave() && gameModel->GetUser().UserID && gameModel->GetSave()->GetID() && gameModel->GetSave()->GetVote()==0)
@@ -2,9 +2,11 @@
 #define GAMECONTROLLER_H
 #include "Config.h"
 
+#include <chrono>
 #include <vector>
 #include <utility>
 #include <memory>
+#include <thread>
 
 #include "client/ClientListener.h"
 
@@ -59,8 +61,18 @@ private:
 	std::unique_ptr<Snapshot> beforeRestore;
 	unsigned int debugFlags;
 	bool autoreloadEnabled;
+	// Set by Update when the simulation is to be stepped while the next frame is drawn
+	bool simulationStepPending;
+	std::thread simulationStep;
+	// Simulation frames per second while fast forwarding, averaged over half a second or so
+	bool fastForwarding;
+	int fastForwardFramesCounted;
+	std::chrono::steady_clock::time_point fastForwardCountStart;
+	float simulationFps;
 	
 	void OpenSaveDone();
+	void StepSimulation();
+	bool CanStepSimulationConcurrently();
 public:
 	bool HasDone;
 	GameController();
@@ -105,6 +117,15 @@ public:
 	void CopyRegion(ui::Point point1, ui::Point point2);
 	void CutRegion(ui::Point point1, ui::Point point2);
 	void Update();
+	// Called by the view around drawing the simulation. If a step is pending, BeginRender
+	// has the renderer draw a copy of the simulation and steps the simulation on a thread
+	// of its own in the meantime; EndRender waits for that step to finish. Nothing else
+	// touches the simulation between the two, so everything else, Lua included, only ever
+	// sees it between steps.
+	void BeginRender();
+	void EndRender();
+	bool GetFastForward();
+	float GetSimulationFps();
 	void SetPaused(bool pauseState);
 	void SetPaused();
 	void SetSubframeMode(bool subframeModeState);
@@ -119,7 +140,7 @@ public:
 	void SetDebugHUD(bool hudState);
 	bool GetDebugHUD();
 	bool GetParticleDebugEnabled() { return debugFlags & 0x8; }
-	void SetDebugFlags(unsigned int flags) { debugFlags = flags; }
+	void SetDebugFlags(unsigned int flags);
 	bool GetAutoreloadEnabled() { return autoreloadEnabled; }
 	void SetAutoreloadEnabled(bool e) { autoreloadEnabled = e; }
 	void SetActiveMenu(int menuID);
@@ -175,6 +196,7 @@ public:
 	bool IsSubframeFrameStepComplete();
 	bool IsFrameComplete();
 	bool AreParticlesInSubframeOrder();
+	int GetSubframeOrderBreaks();
 	void TranslateSave(ui::Point point);
 	void TransformSave(matrix2d transform);
 	void ReRenderSave();
@@ -27,6 +27,7 @@
 #include "simulation/Simulation.h"
 #include "simulation/Snapshot.h"
 #include "simulation/SnapshotDelta.h"
+#include "simulation/SnapshotCompression.h"
 #include "simulation/ElementClasses.h"
 #include "simulation/ElementGraphics.h"
 #include "simulation/ToolClasses.h"
@@ -40,6 +41,28 @@ HistoryEntry::~HistoryEntry()
 	//   so the default dtor for ~HistoryEntry cannot be generated.
 }
 
+size_t HistoryEntry::ByteSize() const
+{
+	size_t size = sizeof(HistoryEntry);
+	if (snap)
+	{
+		size += snap->ByteSize();
+	}
+	if (delta)
+	{
+		size += delta->ByteSize();
+	}
+	if (keyframe)
+	{
+		size += keyframe->ByteSize();
+	}
+	return size;
+}
+
+// * Every this many entries, HistoryPush stores a compressed Snapshot next to the delta,
+//   so long chains of deltas are broken up regularly.
+constexpr int historyKeyframeInterval = 32;
+
 GameModel::GameModel():
 	clipboard(NULL),
 	placeSave(NULL),
@@ -60,6 +83,9 @@ GameModel::GameModel():
 {
 	sim = new Simulation();
 	ren = new Renderer(ui::Engine::Ref().g, sim);
+	// GameView::OnDraw clears the screen before every frame
+	ren->retainFrame = true;
+	renderSim = NULL;
 
 	activeTools = regularToolset;
 
@@ -149,9 +175,10 @@ GameModel::GameModel():
 	colourPresets.push_back(ui::Colour(0, 0, 0));
 
 	undoHistoryLimit = Client::Ref().GetPrefInteger("Simulation.UndoHistoryLimit", 5);
-	// cap due to memory usage (this is about 3.4GB of RAM)
-	if (undoHistoryLimit > 200)
-		SetUndoHistoryLimit(200);
+	// memory usage is capped by undoHistoryMegabytes instead, this just keeps the deque sane
+	if (undoHistoryLimit > 1000)
+		SetUndoHistoryLimit(1000);
+	undoHistoryMegabytes = Client::Ref().GetPrefInteger("Simulation.UndoHistoryMegabytes", 256);
 
 	mouseClickRequired = Client::Ref().GetPrefBool("MouseClickRequired", false);
 	includePressure = Client::Ref().GetPrefBool("Simulation.IncludePressure", true);
@@ -198,6 +225,7 @@ GameModel::~GameModel()
 		delete brushList[i];
 	}
 	delete sim;
+	delete renderSim;
 	delete ren;
 	delete placeSave;
 	delete clipboard;
@@ -229,6 +257,7 @@ void GameModel::BuildQuickOptionMenu(GameController * controller)
 	quickOptions.push_back(new DecorationsOption(this));
 	quickOptions.push_back(new NGravityOption(this));
 	quickOptions.push_back(new AHeatOption(this));
+	quickOptions.push_back(new FastForwardOption(this));
 	quickOptions.push_back(new ConsoleShowOption(this, controller));
 
 	notifyQuickOptionsChanged();
@@ -702,8 +731,17 @@ int GameModel::GetDecoSpace()
 //            |                 |                         |           /   |
 //       ...  |      ...        |          ...            |   ...    ...  |
 //
-//   * After all this, the front of the deque is truncated such that there are on more than
-//     undoHistoryLimit entries left.
+//   * SnapshotDeltas are not stored as they are, but compressed into CompressedSnapshotDeltas,
+//     and decompressed right before they are used. Every historyKeyframeInterval entries, a
+//     compressed copy of the logical Snapshot (a keyframe) is stored alongside the delta; if
+//     the delta is no smaller than the keyframe would be, only the keyframe is kept. An item
+//     with a keyframe is its own logical Snapshot and doesn't depend on the items above it.
+//     Restoring never needs more than one delta, but Forwarding from an item that only has a
+//     keyframe needs the logical Snapshot of the next item, which is obtained by walking down
+//     from the nearest item above it that has a Snapshot or a keyframe (see HistoryLogical).
+//   * After all this, the front of the deque is truncated such that there are no more than
+//     undoHistoryLimit entries left, and that they take up no more than undoHistoryMegabytes
+//     of memory. The last entry is never removed.
 
 const Snapshot *GameModel::HistoryCurrent() const
 {
@@ -715,21 +753,34 @@ bool GameModel::HistoryCanRestore() const
 	return historyPosition > 0U;
 }
 
-void GameModel::HistoryRestore()
+std::unique_ptr<Snapshot> GameModel::HistoryLogical(unsigned int index, const Snapshot *next) const
 {
-	if (!HistoryCanRestore())
+	auto &entry = history[index];
+	if (entry.snap)
 	{
-		return;
+		return std::make_unique<Snapshot>(*entry.snap);
 	}
-	historyPosition -= 1U;
-	if (history[historyPosition].snap)
+	if (entry.keyframe)
 	{
-		historyCurrent = std::make_unique<Snapshot>(*history[historyPosition].snap);
+		return entry.keyframe->Decompress();
 	}
-	else
+	std::unique_ptr<Snapshot> materialised;
+	if (!next)
+	{
+		materialised = HistoryLogical(index + 1U, nullptr);
+		next = materialised.get();
+	}
+	return entry.delta->Decompress()->Restore(*next);
+}
+
+void GameModel::HistoryRestore()
+{
+	if (!HistoryCanRestore())
 	{
-		historyCurrent = history[historyPosition].delta->Restore(*historyCurrent);
+		return;
 	}
+	historyPosition -= 1U;
+	historyCurrent = HistoryLogical(historyPosition, historyCurrent.get());
 }
 
 bool GameModel::HistoryCanForward() const
@@ -748,26 +799,28 @@ void GameModel::HistoryForward()
 	{
 		historyCurrent = nullptr;
 	}
-	else if (history[historyPosition].snap)
+	else if (history[historyPosition].snap || history[historyPosition].keyframe || !history[historyPosition - 1U].delta)
 	{
-		historyCurrent = std::make_unique<Snapshot>(*history[historyPosition].snap);
+		historyCurrent = HistoryLogical(historyPosition, nullptr);
 	}
 	else
 	{
-		historyCurrent = history[historyPosition - 1U].delta->Forward(*historyCurrent);
+		historyCurrent = history[historyPosition - 1U].delta->Decompress()->Forward(*historyCurrent);
 	}
 }
 
 void GameModel::HistoryPush(std::unique_ptr<Snapshot> last)
 {
-	Snapshot *rebaseOnto = nullptr;
+	std::unique_ptr<Snapshot> rebaseOnto;
 	if (historyPosition)
 	{
-		rebaseOnto = history.back().snap.get();
 		if (historyPosition < history.size())
 		{
-			historyCurrent = history[historyPosition - 1U].delta->Restore(*historyCurrent);
-			rebaseOnto = historyCurrent.get();
+			rebaseOnto = HistoryLogical(historyPosition - 1U, historyCurrent.get());
+		}
+		else
+		{
+			rebaseOnto = std::move(history.back().snap);
 		}
 	}
 	while (historyPosition < history.size())
@@ -777,20 +830,48 @@ void GameModel::HistoryPush(std::unique_ptr<Snapshot> last)
 	if (rebaseOnto)
 	{
 		auto &prev = history.back();
-		prev.delta = SnapshotDelta::FromSnapshots(*rebaseOnto, *last);
 		prev.snap.reset();
+		prev.keyframe.reset();
+		prev.delta = std::make_unique<CompressedSnapshotDelta>(*SnapshotDelta::FromSnapshots(*rebaseOnto, *last));
+		auto sinceKeyframe = 1;
+		for (auto it = history.rbegin() + 1; it != history.rend() && !it->keyframe && sinceKeyframe < historyKeyframeInterval; ++it)
+		{
+			sinceKeyframe += 1;
+		}
+		if (sinceKeyframe >= historyKeyframeInterval || prev.delta->ByteSize() > rebaseOnto->ByteSize() / 8)
+		{
+			prev.keyframe = std::make_unique<CompressedSnapshot>(*rebaseOnto);
+			if (prev.delta->ByteSize() >= prev.keyframe->ByteSize())
+			{
+				prev.delta.reset();
+			}
+		}
+		historySpare = std::move(rebaseOnto);
 	}
 	history.emplace_back();
 	history.back().snap = std::move(last);
 	historyPosition += 1U;
 	historyCurrent.reset();
-	while (undoHistoryLimit < history.size())
+	size_t historyBytes = 0;
+	for (auto &entry : history)
 	{
+		historyBytes += entry.ByteSize();
+	}
+	while (history.size() > 1U && (undoHistoryLimit < history.size() || historyBytes > size_t(undoHistoryMegabytes) * 1024U * 1024U))
+	{
+		historyBytes -= history.front().ByteSize();
 		history.pop_front();
 		historyPosition -= 1U;
 	}
 }
 
+std::unique_ptr<Snapshot> GameModel::HistoryTakeSpare()
+{
+	// * The Snapshot last rebased onto in HistoryPush is not needed anymore, but its memory
+	//   can be reused by Simulation::CreateSnapshot for the next one.
+	return std::move(historySpare);
+}
+
 unsigned int GameModel::GetUndoHistoryLimit()
 {
 	return undoHistoryLimit;
@@ -802,6 +883,17 @@ void GameModel::SetUndoHistoryLimit(unsigned int undoHistoryLimit_)
 	Client::Ref().SetPref("Simulation.UndoHistoryLimit", undoHistoryLimit);
 }
 
+unsigned int GameModel::GetUndoHistoryMegabytes()
+{
+	return undoHistoryMegabytes;
+}
+
+void GameModel::SetUndoHistoryMegabytes(unsigned int undoHistoryMegabytes_)
+{
+	undoHistoryMegabytes = undoHistoryMegabytes_;
+	Client::Ref().SetPref("Simulation.UndoHistoryMegabytes", undoHistoryMegabytes);
+}
+
 void GameModel::SetVote(int direction)
 {
 	if(currentSave)
@@ -1086,6 +1178,29 @@ Renderer * GameModel::GetRenderer()
 	return ren;
 }
 
+void GameModel::SetThreadedSimulation(bool threaded)
+{
+	if (threaded && !renderSim)
+	{
+		renderSim = new Simulation();
+	}
+	else if (!threaded && renderSim)
+	{
+		delete renderSim;
+		renderSim = NULL;
+	}
+}
+
+bool GameModel::GetThreadedSimulation()
+{
+	return renderSim != NULL;
+}
+
+Simulation * GameModel::GetRenderSimulation()
+{
+	return renderSim;
+}
+
 User GameModel::GetUser()
 {
 	return currentUser;
@@ -1697,6 +1812,25 @@ void GameModel::SetPerfectCircle(bool perfectCircle)
 	}
 }
 
+void GameModel::SetFastForward(bool fastForward)
+{
+	if (fastForward != this->fastForward)
+	{
+		this->fastForward = fastForward;
+		UpdateQuickOptions();
+		if (fastForward)
+			SetInfoTip("Fast forward: On");
+		else
+			SetInfoTip("Fast forward: Off");
+	}
+}
+
+void GameModel::SetFastForwardLimits(int frames, int interval)
+{
+	fastForwardFrames = frames;
+	fastForwardInterval = interval;
+}
+
 bool GameModel::RemoveCustomGOLType(const ByteString &identifier)
 {
 	bool removedAny = false;
@@ -23,6 +23,8 @@ class Simulation;
 class Renderer;
 class Snapshot;
 struct SnapshotDelta;
+class CompressedSnapshot;
+class CompressedSnapshotDelta;
 class GameSave;
 
 class ToolSelection
@@ -37,9 +39,12 @@ public:
 struct HistoryEntry
 {
 	std::unique_ptr<Snapshot> snap;
-	std::unique_ptr<SnapshotDelta> delta;
+	std::unique_ptr<CompressedSnapshotDelta> delta;
+	std::unique_ptr<CompressedSnapshot> keyframe;
 
 	~HistoryEntry();
+
+	size_t ByteSize() const;
 };
 
 class GameModel
@@ -61,6 +66,9 @@ private:
 
 	Simulation * sim;
 	Renderer * ren;
+	// Holds a copy of sim for ren to draw while sim is stepped on another thread, NULL unless
+	// that is enabled, see GameController::BeginRender
+	Simulation * renderSim;
 	std::vector<Menu*> menuList;
 	std::vector<QuickOption*> quickOptions;
 	int activeMenu;
@@ -77,12 +85,20 @@ private:
 	float toolStrength;
 	std::deque<HistoryEntry> history;
 	std::unique_ptr<Snapshot> historyCurrent;
+	std::unique_ptr<Snapshot> historySpare;
+	std::unique_ptr<Snapshot> HistoryLogical(unsigned int index, const Snapshot *next) const;
 	bool wasModified;
 	unsigned int historyPosition;
 	unsigned int undoHistoryLimit;
+	unsigned int undoHistoryMegabytes;
 	bool mouseClickRequired;
 	bool includePressure;
 	bool perfectCircle = true;
+	// Fast forward steps the simulation until either limit is reached before drawing a
+	// frame, 0 meaning no limit; see GameController::Update
+	bool fastForward = false;
+	int fastForwardFrames = 0;
+	int fastForwardInterval = 100;
 
 	size_t activeColourPreset;
 	std::vector<ui::Colour> colourPresets;
@@ -159,8 +175,11 @@ public:
 	bool HistoryCanForward() const;
 	void HistoryForward();
 	void HistoryPush(std::unique_ptr<Snapshot> last);
+	std::unique_ptr<Snapshot> HistoryTakeSpare();
 	unsigned int GetUndoHistoryLimit();
 	void SetUndoHistoryLimit(unsigned int undoHistoryLimit_);
+	unsigned int GetUndoHistoryMegabytes();
+	void SetUndoHistoryMegabytes(unsigned int undoHistoryMegabytes_);
 
 	void UpdateQuickOptions();
 
@@ -216,6 +235,9 @@ public:
 	void SetUser(User user);
 	Simulation * GetSimulation();
 	Renderer * GetRenderer();
+	void SetThreadedSimulation(bool threaded);
+	bool GetThreadedSimulation();
+	Simulation * GetRenderSimulation();
 	void SetZoomEnabled(bool enabled);
 	bool GetZoomEnabled();
 	void SetZoomSize(int size);
@@ -243,6 +265,21 @@ public:
 	{
 		return perfectCircle;
 	}
+	void SetFastForward(bool fastForward);
+	inline bool GetFastForward() const
+	{
+		return fastForward;
+	}
+	// frames per drawn frame and milliseconds between drawn frames, not both 0
+	void SetFastForwardLimits(int frames, int interval);
+	inline int GetFastForwardFrames() const
+	{
+		return fastForwardFrames;
+	}
+	inline int GetFastForwardInterval() const
+	{
+		return fastForwardInterval;
+	}
 
 	std::vector<Notification*> GetNotifications();
 	void AddNotification(Notification * notification);
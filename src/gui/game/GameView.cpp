@@ -18,6 +18,8 @@
 #include "client/SaveInfo.h"
 #include "client/SaveFile.h"
 #include "client/Client.h"
+#include "client/ImageWriter.h"
+#include "client/VideoRecording.h"
 #include "common/Platform.h"
 #include "graphics/Graphics.h"
 #include "graphics/Renderer.h"
@@ -196,7 +198,7 @@ GameView::GameView():
 	doScreenshot(false),
 	screenshotIndex(0),
 	recording(false),
-	recordingFolder(0),
+	recordingId(0),
 	recordingSubframe(false),
 	recordInterval(1),
 	recordIntervalIndex(0),
@@ -931,7 +933,9 @@ int GameView::Record(bool record, bool subframe)
 	if (!record)
 	{
 		recording = false;
-		recordingFolder = 0;
+		recordingId = 0;
+		// waits for the frames still queued to be written
+		recordingWriter.reset();
 		recordingSubframe = false;
 		recordIntervalIndex = 0;
 	}
@@ -944,14 +948,22 @@ int GameView::Record(bool record, bool subframe)
 	{
 		// block so that the return value is correct
 		String subframeRecordConfirmMessage = "You're about to start recording all remaining particle updates in this frame. This may use a load of disk space.";
-		String nonSubframeRecordConfirmMessage = "You're about to start recording all drawn frames. This will use a load of disk space.";
+		String nonSubframeRecordConfirmMessage = "You're about to start recording all drawn frames. This may use a load of disk space.";
 		bool record = ConfirmPrompt::Blocking("Recording", subframe ? subframeRecordConfirmMessage : nonSubframeRecordConfirmMessage);
 		if (record)
 		{
 			time_t startTime = time(NULL);
-			recordingFolder = startTime;
 			Platform::MakeDirectory("recordings");
-			Platform::MakeDirectory(ByteString::Build("recordings", PATH_SEP, recordingFolder).c_str());
+			try
+			{
+				recordingWriter = std::make_unique<VideoRecordingWriter>(ByteString::Build("recordings", PATH_SEP, startTime, ".rec"), XRES, YRES);
+			}
+			catch (std::exception &e)
+			{
+				new ErrorMessage("Recording", ByteString(e.what()).FromUtf8());
+				return 0;
+			}
+			recordingId = startTime;
 			recording = true;
 			recordIntervalIndex = 0;
 
@@ -962,7 +974,7 @@ int GameView::Record(bool record, bool subframe)
 			}
 		}
 	}
-	return recordingFolder;
+	return recordingId;
 }
 
 void GameView::updateToolButtonScroll()
@@ -2133,6 +2145,7 @@ void GameView::OnDraw()
 	Graphics * g = GetGraphics();
 	if (ren)
 	{
+		c->BeginRender();
 		ren->clearScreen(1.0f);
 		ren->RenderBegin();
 		ren->SetSample(c->PointTranslate(currentMouse).X, c->PointTranslate(currentMouse).Y);
@@ -2248,26 +2261,24 @@ void GameView::OnDraw()
 		}
 
 		ren->RenderEnd();
+		c->EndRender();
 
 		if(doScreenshot)
 		{
-			VideoBuffer screenshot(ren->DumpFrame());
-			std::vector<char> data = format::VideoBufferToPNG(screenshot);
-
 			ByteString filename = ByteString::Build("screenshot_", Format::Width(screenshotIndex++, 6), ".png");
-
-			Client::Ref().WriteFile(data, filename);
+			ImageWriter::Ref().Add(std::make_unique<VideoBuffer>(ren->DumpFrame()), ImageWriter::PNG, filename);
 			doScreenshot = false;
 		}
 
 		if (recording && recordIntervalIndex == 0)
 		{
-			VideoBuffer screenshot(ren->DumpFrame());
-			std::vector<char> data = format::VideoBufferToPPM(screenshot);
-
-			ByteString filename = ByteString::Build("recordings", PATH_SEP, recordingFolder, PATH_SEP, "frame_", Format::Width(screenshotIndex++, 6), ".ppm");
-
-			Client::Ref().WriteFile(data, filename);
+			recordingWriter->AddFrame(ren->DumpFrame());
+			screenshotIndex++;
+			if (recordingWriter->Failed())
+			{
+				Record(false);
+				new ErrorMessage("Recording", "Could not write the recording, it has been stopped");
+			}
 		}
 
 		if (recording)
@@ -2564,6 +2575,8 @@ void GameView::OnDraw()
 		//FPS and some version info
 		StringBuilder fpsInfo;
 		fpsInfo << Format::Precision(2) << "FPS: " << ui::Engine::Ref().GetFps();
+		if (c->GetFastForward())
+			fpsInfo << " [FF: " << Format::Precision(c->GetSimulationFps(), 0) << " sim FPS]";
 
 		if (showDebug)
 		{
@@ -2576,6 +2589,8 @@ void GameView::OnDraw()
 			fpsInfo << " [Subf: #" << c->GetParticleDebugPosition() << "]";
 		if (c->GetStackEditDepth() >= 0)
 			fpsInfo << " [StackE: " << c->GetStackEditDepth() << "]";
+		if (!c->AreParticlesInSubframeOrder())
+			fpsInfo << " [Unord: " << c->GetSubframeOrderBreaks() << "]";
 		if (configTool)
 			fpsInfo << " [Config]";
 		if (c->GetReplaceModeFlags()&REPLACE_MODE)
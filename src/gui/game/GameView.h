@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <deque>
+#include <memory>
 #include "common/String.h"
 #include "gui/interface/Window.h"
 
@@ -33,6 +34,7 @@ class SplitButton;
 class MenuButton;
 class Renderer;
 class VideoBuffer;
+class VideoRecordingWriter;
 class ToolButton;
 class GameController;
 class Brush;
@@ -77,7 +79,9 @@ private:
 	bool doScreenshot;
 	int screenshotIndex;
 	bool recording;
-	int recordingFolder;
+	// recordings go to recordings/<recordingId>.rec
+	int recordingId;
+	std::unique_ptr<VideoRecordingWriter> recordingWriter;
 	bool recordingSubframe;
 	int recordInterval;
 	int recordIntervalIndex;
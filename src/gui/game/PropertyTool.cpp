@@ -352,6 +352,8 @@ void PropertyTool::SetProperty(Simulation *sim, ui::Point position)
 	{
 		case StructProperty::Float:
 			*((float*)(((char*)&sim->parts[ID(i)])+propOffset)) = propValue.Float;
+			// in case it was x or y
+			sim->UpdateSubframeOrder(ID(i));
 			break;
 		case StructProperty::ParticleType:
 		case StructProperty::Integer:
@@ -85,6 +85,22 @@ void AHeatOption::perform()
 
 
 
+FastForwardOption::FastForwardOption(GameModel * m):
+QuickOption("F", "Fast forward, step the simulation many times per drawn frame", m, Toggle)
+{
+
+}
+bool FastForwardOption::GetToggle()
+{
+	return m->GetFastForward();
+}
+void FastForwardOption::perform()
+{
+	m->SetFastForward(!m->GetFastForward());
+}
+
+
+
 ConsoleShowOption::ConsoleShowOption(GameModel * m, GameController * c_):
 QuickOption("C", "Show Console \bg(~)", m, Toggle)
 {
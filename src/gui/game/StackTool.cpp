@@ -90,6 +90,8 @@ void StackTool::ProcessParts(Simulation *sim, std::vector<int> &parts, ui::Point
 				sim->photons[ny][nx] = PMAP(partID, t);
 			else
 				sim->pmap[ny][nx] = PMAP(partID, t);
+			sim->MarkPmapDirty(nx, ny);
+			sim->UpdateSubframeOrder(partID);
 		}
 	}
 	else
@@ -12,6 +12,7 @@
 #include "PowderToy.h"
 
 #include "client/Client.h"
+#include "client/VideoRecording.h"
 #include "common/Platform.h"
 #include "graphics/Graphics.h"
 #include "graphics/Renderer.h"
@@ -131,6 +132,8 @@ int luacon_partwrite(lua_State* l)
 		break;
 	case CommandInterface::FormatFloat:
 		*((float*)(((unsigned char*)&luacon_sim->parts[i])+offset)) = luaL_optnumber(l, 3, 0);
+		// x and y are floats
+		luacon_sim->UpdateSubframeOrder(i);
 		break;
 	case CommandInterface::FormatElement:
 		luacon_sim->part_change_type(i, int(luacon_sim->parts[i].x + 0.5f), int(luacon_sim->parts[i].y + 0.5f), luaL_optinteger(l, 3, 0));
@@ -776,7 +779,10 @@ int luatpt_set_property(lua_State* l)
 					if (format == CommandInterface::FormatElement)
 						luacon_sim->part_change_type(i, nx, ny, t);
 					else if(format == CommandInterface::FormatFloat)
+					{
 						*((float*)(((unsigned char*)&luacon_sim->parts[i])+offset)) = f;
+						luacon_sim->UpdateSubframeOrder(i);
+					}
 					else
 						*((int*)(((unsigned char*)&luacon_sim->parts[i])+offset)) = t;
 				}
@@ -809,7 +815,10 @@ int luatpt_set_property(lua_State* l)
 		if (format == CommandInterface::FormatElement)
 			luacon_sim->part_change_type(i, int(luacon_sim->parts[i].x + 0.5f), int(luacon_sim->parts[i].y + 0.5f), t);
 		else if (format == CommandInterface::FormatFloat)
+		{
 			*((float*)(((unsigned char*)&luacon_sim->parts[i])+offset)) = f;
+			luacon_sim->UpdateSubframeOrder(i);
+		}
 		else
 			*((int*)(((unsigned char*)&luacon_sim->parts[i])+offset)) = t;
 	}
@@ -1573,6 +1582,43 @@ int luatpt_setrecordinterval(lua_State* l)
 	return 0;
 }
 
+int luatpt_record_export(lua_State* l)
+{
+	// writes frames first to last of a recording to folder as PNGs, returns how many it wrote
+	ByteString filename = luaL_checkstring(l, 1);
+	ByteString folder = luaL_checkstring(l, 2);
+	int first = luaL_optint(l, 3, 0);
+	int last = luaL_optint(l, 4, -1);
+	ByteString error;
+	int written = 0;
+	// errors are raised once the reader is gone, luaL_error doesn't unwind the stack
+	try
+	{
+		VideoRecordingReader reader(filename);
+		if (last < 0 || last >= reader.FrameCount())
+			last = reader.FrameCount() - 1;
+		Platform::MakeDirectory(folder);
+		for (int index = std::max(first, 0); index <= last; index++)
+		{
+			ByteString frameFilename = ByteString::Build(folder, PATH_SEP, "frame_", Format::Width(index, 6), ".png");
+			if (Client::Ref().WriteFile(format::VideoBufferToPNG(reader.Frame(index)), frameFilename))
+			{
+				error = ByteString::Build("could not write ", frameFilename);
+				break;
+			}
+			written++;
+		}
+	}
+	catch (std::exception &e)
+	{
+		error = e.what();
+	}
+	if (error.size())
+		return luaL_error(l, "%s", error.c_str());
+	lua_pushinteger(l, written);
+	return 1;
+}
+
 int luatpt_set_bray_life_brightness_threshold(lua_State* l)
 {
 	int acount = lua_gettop(l);
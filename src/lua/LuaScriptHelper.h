@@ -137,6 +137,7 @@ int luatpt_screenshot(lua_State* l);
 int luatpt_record(lua_State* l);
 int luatpt_record_subframe(lua_State* l);
 int luatpt_setrecordinterval(lua_State* l);
+int luatpt_record_export(lua_State* l);
 
 int luatpt_perfectCircle(lua_State* l);
 
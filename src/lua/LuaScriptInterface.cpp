@@ -217,6 +217,7 @@ LuaScriptInterface::LuaScriptInterface(GameController * c, GameModel * m):
 		{"record",&luatpt_record},
 		{"record_subframe",&luatpt_record_subframe},
 		{"setrecordinterval",&luatpt_setrecordinterval},
+		{"record_export",&luatpt_record_export},
 		{"element",&luatpt_getelement},
 		{"element_func",&luatpt_element_func},
 		{"graphics_func",&luatpt_graphics_func},
@@ -866,6 +867,17 @@ void LuaScriptInterface::initSimulationAPI()
 		{"addCustomGol", simulation_addCustomGol},
 		{"removeCustomGol", simulation_removeCustomGol},
 		{"reloadParticleOrder", simulation_reloadParticleOrder},
+		{"randomseed", simulation_randomseed},
+		{"stepParticles", simulation_stepParticles},
+		{"addBreakpoint", simulation_addBreakpoint},
+		{"clearBreakpoints", simulation_clearBreakpoints},
+		{"stateHash", simulation_stateHash},
+		{"profiler", simulation_profiler},
+		{"resetProfiler", simulation_resetProfiler},
+		{"saveProfile", simulation_saveProfile},
+		{"skipSettled", simulation_skipSettled},
+		{"threadedStep", simulation_threadedStep},
+		{"fastForward", simulation_fastForward},
 		{NULL, NULL}
 	};
 	luaL_register(l, "simulation", simulationAPIMethods);
@@ -910,6 +922,13 @@ void LuaScriptInterface::initSimulationAPI()
 	SETCONST(l, PMAPBITS);
 	SETCONST(l, PMAPMASK);
 
+	lua_pushinteger(l, ParticleBreakpoint::Id); lua_setfield(l, -2, "BREAK_ID");
+	lua_pushinteger(l, ParticleBreakpoint::Type); lua_setfield(l, -2, "BREAK_TYPE");
+	lua_pushinteger(l, ParticleBreakpoint::Position); lua_setfield(l, -2, "BREAK_POSITION");
+	lua_pushinteger(l, ParticleBreakpoint::Property); lua_setfield(l, -2, "BREAK_PROPERTY");
+	lua_pushinteger(l, ParticleBreakpoint::PropertyAt); lua_setfield(l, -2, "BREAK_PROPERTY_AT");
+	lua_pushinteger(l, ParticleBreakpoint::InterestingChange); lua_setfield(l, -2, "BREAK_INTERESTING");
+
 	//Declare FIELD_BLAH constants
 	{
 		int particlePropertiesCount = 0;
@@ -1086,6 +1105,7 @@ int LuaScriptInterface::simulation_partPosition(lua_State * l)
 	{
 		luacon_sim->parts[particleID].x = lua_tonumber(l, 2);
 		luacon_sim->parts[particleID].y = lua_tonumber(l, 3);
+		luacon_sim->UpdateSubframeOrder(particleID);
 		return 0;
 	}
 	else
@@ -1150,6 +1170,8 @@ int LuaScriptInterface::simulation_partProperty(lua_State * l)
 		else
 		{
 			LuaSetProperty(l, *prop, propertyAddress, 3);
+			// in case it was x or y
+			luacon_sim->UpdateSubframeOrder(particleID);
 		}
 		return 0;
 	}
@@ -2362,6 +2384,200 @@ int LuaScriptInterface::simulation_reloadParticleOrder(lua_State * l)
 	return 0;
 }
 
+// Takes the low 32 bits of a whole number argument, negative ones included. Casting a
+// double straight to unsigned int is undefined for those and for anything past 2^32.
+static uint32_t CheckRandomWord(lua_State *l, int n)
+{
+	double value = luaL_checknumber(l, n);
+	if (!(value > -9223372036854775808.0 && value < 9223372036854775808.0))
+		return luaL_argerror(l, n, "out of range");
+	return uint32_t(uint64_t(int64_t(value)));
+}
+
+int LuaScriptInterface::simulation_randomseed(lua_State * l)
+{
+	// the state is passed around as four 32-bit halves, lua numbers can't hold 64-bit integers
+	int args = lua_gettop(l);
+	if (args == 0)
+	{
+		auto state = luacon_sim->rng.state();
+		for (auto word : state)
+		{
+			lua_pushnumber(l, double(word & 0xFFFFFFFFU));
+			lua_pushnumber(l, double(word >> 32));
+		}
+		return 4;
+	}
+	if (args == 1)
+	{
+		luacon_sim->rng.seed(CheckRandomWord(l, 1));
+		return 0;
+	}
+	RNG::State state;
+	for (int i = 0; i < 2; i++)
+	{
+		uint64_t lo = CheckRandomWord(l, i * 2 + 1);
+		uint64_t hi = CheckRandomWord(l, i * 2 + 2);
+		state[i] = lo | (hi << 32);
+	}
+	if (!state[0] && !state[1])
+		return luaL_error(l, "Invalid random state");
+	luacon_sim->rng.state(state);
+	return 0;
+}
+
+int LuaScriptInterface::simulation_stepParticles(lua_State *l)
+{
+	if (luacon_sim->debug_stepping)
+		return luaL_error(l, "Can't step particles from inside the particle loop");
+	int i = luacon_sim->StepParticles();
+	if (i == NPART)
+		return 0;
+	lua_pushinteger(l, i);
+	return 1;
+}
+
+int LuaScriptInterface::simulation_addBreakpoint(lua_State *l)
+{
+	if (luacon_sim->debug_stepping)
+		return luaL_error(l, "Can't change breakpoints from inside the particle loop");
+	ParticleBreakpoint breakpoint{};
+	breakpoint.kind = ParticleBreakpoint::Kind(luaL_checkinteger(l, 1));
+	switch (breakpoint.kind)
+	{
+	case ParticleBreakpoint::Id:
+	case ParticleBreakpoint::Property:
+		breakpoint.value = luaL_checkinteger(l, 2);
+		if (breakpoint.value < 0 || breakpoint.value >= NPART)
+			return luaL_error(l, "Invalid particle ID (%d)", breakpoint.value);
+		break;
+
+	case ParticleBreakpoint::Type:
+		breakpoint.value = luaL_checkinteger(l, 2);
+		if (!luacon_sim->IsElement(breakpoint.value))
+			return luaL_error(l, "Invalid element ID (%d)", breakpoint.value);
+		break;
+
+	case ParticleBreakpoint::Position:
+	case ParticleBreakpoint::PropertyAt:
+		breakpoint.x = luaL_checkinteger(l, 2);
+		breakpoint.y = luaL_checkinteger(l, 3);
+		if (breakpoint.x < 0 || breakpoint.x >= XRES || breakpoint.y < 0 || breakpoint.y >= YRES)
+			return luaL_error(l, "coordinates out of range (%d,%d)", breakpoint.x, breakpoint.y);
+		break;
+
+	case ParticleBreakpoint::InterestingChange:
+		break;
+
+	default:
+		return luaL_error(l, "Invalid breakpoint kind");
+	}
+	if (breakpoint.kind == ParticleBreakpoint::Property || breakpoint.kind == ParticleBreakpoint::PropertyAt)
+	{
+		auto &properties = Particle::GetProperties();
+		int fieldArg = breakpoint.kind == ParticleBreakpoint::Property ? 3 : 4;
+		ByteString fieldName = luaL_checkstring(l, fieldArg);
+		auto prop = std::find_if(properties.begin(), properties.end(), [&fieldName](StructProperty const &p) {
+			return p.Name == fieldName;
+		});
+		if (prop == properties.end())
+			return luaL_error(l, "Unknown field (%s)", fieldName.c_str());
+		breakpoint.offset = prop->Offset;
+	}
+	luacon_sim->AddBreakpoint(breakpoint);
+	return 0;
+}
+
+int LuaScriptInterface::simulation_clearBreakpoints(lua_State *l)
+{
+	if (luacon_sim->debug_stepping)
+		return luaL_error(l, "Can't change breakpoints from inside the particle loop");
+	luacon_sim->debug_breakpoints.clear();
+	return 0;
+}
+
+int LuaScriptInterface::simulation_stateHash(lua_State *l)
+{
+	// lua numbers can't hold 64-bit integers, so this is a hex string
+	ByteString hash = ByteString::Build(Format::Hex(), Format::Fill('0'), Format::Width(16), (unsigned long long int)luacon_sim->StateHash());
+	lua_pushstring(l, hash.c_str());
+	return 1;
+}
+
+int LuaScriptInterface::simulation_profiler(lua_State *l)
+{
+	int acount = lua_gettop(l);
+	if (acount == 0)
+	{
+		lua_pushboolean(l, luacon_sim->profiler.enabled);
+		return 1;
+	}
+	luacon_sim->profiler.enabled = lua_toboolean(l, 1);
+	return 0;
+}
+
+int LuaScriptInterface::simulation_resetProfiler(lua_State *l)
+{
+	luacon_sim->profiler.Reset();
+	return 0;
+}
+
+int LuaScriptInterface::simulation_saveProfile(lua_State *l)
+{
+	ByteString filename = luaL_checkstring(l, 1);
+	ByteString report = luacon_sim->profiler.Report(luacon_sim->elements.data());
+	if (Client::Ref().WriteFile(std::vector<char>(report.begin(), report.end()), filename))
+		return luaL_error(l, "could not write %s", filename.c_str());
+	return 0;
+}
+
+int LuaScriptInterface::simulation_skipSettled(lua_State *l)
+{
+	int acount = lua_gettop(l);
+	if (acount == 0)
+	{
+		lua_pushboolean(l, luacon_sim->skipSettledParticles);
+		return 1;
+	}
+	luacon_sim->skipSettledParticles = lua_toboolean(l, 1);
+	return 0;
+}
+
+int LuaScriptInterface::simulation_threadedStep(lua_State *l)
+{
+	int acount = lua_gettop(l);
+	if (acount == 0)
+	{
+		lua_pushboolean(l, luacon_model->GetThreadedSimulation());
+		return 1;
+	}
+	luacon_model->SetThreadedSimulation(lua_toboolean(l, 1));
+	return 0;
+}
+
+int LuaScriptInterface::simulation_fastForward(lua_State *l)
+{
+	int acount = lua_gettop(l);
+	if (acount == 0)
+	{
+		lua_pushboolean(l, luacon_model->GetFastForward());
+		lua_pushinteger(l, luacon_model->GetFastForwardFrames());
+		lua_pushinteger(l, luacon_model->GetFastForwardInterval());
+		lua_pushnumber(l, luacon_controller->GetSimulationFps());
+		return 4;
+	}
+	if (acount > 1)
+	{
+		int frames = luaL_checkint(l, 2);
+		int interval = luaL_optint(l, 3, luacon_model->GetFastForwardInterval());
+		if (frames < 0 || interval < 0 || (!frames && !interval))
+			return luaL_error(l, "Invalid fast forward limits, a frame count or an interval is needed");
+		luacon_model->SetFastForwardLimits(frames, interval);
+	}
+	luacon_model->SetFastForward(lua_toboolean(l, 1));
+	return 0;
+}
+
 //// Begin Renderer API
 
 void LuaScriptInterface::initRendererAPI()
@@ -118,6 +118,17 @@ class LuaScriptInterface: public CommandInterface
 	static int simulation_addCustomGol(lua_State *l);
 	static int simulation_removeCustomGol(lua_State *l);
 	static int simulation_reloadParticleOrder(lua_State *l);
+	static int simulation_randomseed(lua_State *l);
+	static int simulation_stepParticles(lua_State *l);
+	static int simulation_addBreakpoint(lua_State *l);
+	static int simulation_clearBreakpoints(lua_State *l);
+	static int simulation_stateHash(lua_State *l);
+	static int simulation_profiler(lua_State *l);
+	static int simulation_resetProfiler(lua_State *l);
+	static int simulation_saveProfile(lua_State *l);
+	static int simulation_skipSettled(lua_State *l);
+	static int simulation_threadedStep(lua_State *l);
+	static int simulation_fastForward(lua_State *l);
 
 
 	//Renderer
@@ -6,6 +6,7 @@
 #include "Simulation.h"
 #include "ElementClasses.h"
 #include "common/tpt-rand.h"
+#include "common/ThreadPool.h"
 
 /*float kernel[9];
 
@@ -53,9 +54,7 @@ void Air::ClearAirH()
 
 void Air::update_airh(void)
 {
-	int x, y, i, j;
-	float odh, dh, dx, dy, f, tx, ty;
-	for (i=0; i<YRES/CELL; i++) //reduces pressure/velocity on the edges every frame
+	for (int i=0; i<YRES/CELL; i++) //reduces pressure/velocity on the edges every frame
 	{
 		hv[i][0] = ambientAirTemp;
 		hv[i][1] = ambientAirTemp;
@@ -63,7 +62,7 @@ void Air::update_airh(void)
 		hv[i][XRES/CELL-2] = ambientAirTemp;
 		hv[i][XRES/CELL-1] = ambientAirTemp;
 	}
-	for (i=0; i<XRES/CELL; i++) //reduces pressure/velocity on the edges every frame
+	for (int i=0; i<XRES/CELL; i++) //reduces pressure/velocity on the edges every frame
 	{
 		hv[0][i] = ambientAirTemp;
 		hv[1][i] = ambientAirTemp;
@@ -71,7 +70,40 @@ void Air::update_airh(void)
 		hv[YRES/CELL-2][i] = ambientAirTemp;
 		hv[YRES/CELL-1][i] = ambientAirTemp;
 	}
-	for (y=0; y<YRES/CELL; y++) //update velocity and pressure
+	// Hot air rising used to be applied to vy in the same sweep that reads vy below, so every
+	// cell saw already-updated velocities in the row above and in the cell to its left, and
+	// the old ones everywhere else. Work out the updated velocities first so that rows can be
+	// processed independently while still reading exactly the same values.
+	if (!sim.gravityMode)
+	{
+		ThreadPool::Ref().ParallelFor(0, YRES/CELL, rowsPerJob, [this](int rowBegin, int rowEnd) {
+			for (int y=rowBegin; y<rowEnd; y++)
+			{
+				for (int x=0; x<XRES/CELL; x++)
+				{ //Vertical gravity only for the time being
+					float airdiff = hv[y-1][x]-hv[y][x];
+					if(airdiff>0 && !(bmap_blockairh[y-1][x]&0x8))
+						risenvy[y][x] = vy[y][x] - airdiff/5000.0f;
+					else
+						risenvy[y][x] = vy[y][x];
+				}
+			}
+		});
+	}
+	else
+		memcpy(risenvy, vy, sizeof(vy));
+	ThreadPool::Ref().ParallelFor(0, YRES/CELL, rowsPerJob, [this](int rowBegin, int rowEnd) {
+		update_airh_rows(rowBegin, rowEnd);
+	});
+	memcpy(vy, risenvy, sizeof(vy));
+	memcpy(hv, ohv, sizeof(hv));
+}
+
+void Air::update_airh_rows(int rowBegin, int rowEnd)
+{
+	int x, y, i, j;
+	float odh, dh, dx, dy, f, tx, ty;
+	for (y=rowBegin; y<rowEnd; y++) //update velocity and pressure
 	{
 		for (x=0; x<XRES/CELL; x++)
 		{
@@ -89,7 +121,7 @@ void Air::update_airh(void)
 						f = kernel[i+1+(j+1)*3];
 						dh += hv[y+j][x+i]*f;
 						dx += vx[y+j][x+i]*f;
-						dy += vy[y+j][x+i]*f;
+						dy += ((j<0 || (j==0 && i<0)) ? risenvy : vy)[y+j][x+i]*f;
 					}
 					else
 					{
@@ -115,25 +147,14 @@ void Air::update_airh(void)
 				dh += AIR_VADV*(1.0f-tx)*ty*((bmap_blockairh[j+1][i]&0x8) ? odh : hv[j+1][i]);
 				dh += AIR_VADV*tx*ty*((bmap_blockairh[j+1][i+1]&0x8) ? odh : hv[j+1][i+1]);
 			}
-			if(!sim.gravityMode)
-			{ //Vertical gravity only for the time being
-				float airdiff = hv[y-1][x]-hv[y][x];
-				if(airdiff>0 && !(bmap_blockairh[y-1][x]&0x8))
-					vy[y][x] -= airdiff/5000.0f;
-			}
 			ohv[y][x] = dh;
 		}
 	}
-	memcpy(hv, ohv, sizeof(hv));
 }
 
 void Air::update_air(void)
 {
-	int x = 0, y = 0, i = 0, j = 0;
-	float dp = 0.0f, dx = 0.0f, dy = 0.0f, f = 0.0f, tx = 0.0f, ty = 0.0f;
-	const float advDistanceMult = 0.7f;
-	float stepX, stepY;
-	int stepLimit, step;
+	int i = 0, j = 0;
 
 	if (airMode != 4) { //airMode 4 is no air/pressure update
 
@@ -184,160 +205,179 @@ void Air::update_air(void)
 			}
 		}
 
-		for (y=1; y<YRES/CELL; y++) //pressure adjustments from velocity
-			for (x=1; x<XRES/CELL; x++)
-			{
-				dp = 0.0f;
-				dp += vx[y][x-1] - vx[y][x];
-				dp += vy[y-1][x] - vy[y][x];
-				pv[y][x] *= AIR_PLOSS;
-				pv[y][x] += dp*AIR_TSTEPP;
-			}
-
-		for (y=0; y<YRES/CELL-1; y++) //velocity adjustments from pressure
-			for (x=0; x<XRES/CELL-1; x++)
-			{
-				dx = dy = 0.0f;
-				dx += pv[y][x] - pv[y][x+1];
-				dy += pv[y][x] - pv[y+1][x];
-				vx[y][x] *= AIR_VLOSS;
-				vy[y][x] *= AIR_VLOSS;
-				vx[y][x] += dx*AIR_TSTEPV;
-				vy[y][x] += dy*AIR_TSTEPV;
-				if (bmap_blockair[y][x] || bmap_blockair[y][x+1])
-					vx[y][x] = 0;
-				if (bmap_blockair[y][x] || bmap_blockair[y+1][x])
-					vy[y][x] = 0;
-			}
+		// every cell below only writes to itself and reads arrays that the loop doesn't
+		// write to, so the grid can be split into bands of rows without changing the result
+		ThreadPool::Ref().ParallelFor(1, YRES/CELL, rowsPerJob, [this](int rowBegin, int rowEnd) {
+			for (int y=rowBegin; y<rowEnd; y++) //pressure adjustments from velocity
+				for (int x=1; x<XRES/CELL; x++)
+				{
+					float dp = 0.0f;
+					dp += vx[y][x-1] - vx[y][x];
+					dp += vy[y-1][x] - vy[y][x];
+					pv[y][x] *= AIR_PLOSS;
+					pv[y][x] += dp*AIR_TSTEPP;
+				}
+		});
 
-		for (y=0; y<YRES/CELL; y++) //update velocity and pressure
-			for (x=0; x<XRES/CELL; x++)
-			{
-				dx = 0.0f;
-				dy = 0.0f;
-				dp = 0.0f;
-				for (j=-1; j<2; j++)
-					for (i=-1; i<2; i++)
-						if (y+j>0 && y+j<YRES/CELL-1 &&
-						        x+i>0 && x+i<XRES/CELL-1 &&
-						        !bmap_blockair[y+j][x+i])
-						{
-							f = kernel[i+1+(j+1)*3];
-							dx += vx[y+j][x+i]*f;
-							dy += vy[y+j][x+i]*f;
-							dp += pv[y+j][x+i]*f;
-						}
-						else
-						{
-							f = kernel[i+1+(j+1)*3];
-							dx += vx[y][x]*f;
-							dy += vy[y][x]*f;
-							dp += pv[y][x]*f;
-						}
-
-				tx = x - dx*advDistanceMult;
-				ty = y - dy*advDistanceMult;
-				if ((dx*advDistanceMult>1.0f || dy*advDistanceMult>1.0f) && (tx>=2 && tx<XRES/CELL-2 && ty>=2 && ty<YRES/CELL-2))
+		ThreadPool::Ref().ParallelFor(0, YRES/CELL-1, rowsPerJob, [this](int rowBegin, int rowEnd) {
+			for (int y=rowBegin; y<rowEnd; y++) //velocity adjustments from pressure
+				for (int x=0; x<XRES/CELL-1; x++)
 				{
-					// Trying to take velocity from far away, check whether there is an intervening wall. Step from current position to desired source location, looking for walls, with either the x or y step size being 1 cell
-					if (std::abs(dx)>std::abs(dy))
+					float dx = 0.0f, dy = 0.0f;
+					dx += pv[y][x] - pv[y][x+1];
+					dy += pv[y][x] - pv[y+1][x];
+					vx[y][x] *= AIR_VLOSS;
+					vy[y][x] *= AIR_VLOSS;
+					vx[y][x] += dx*AIR_TSTEPV;
+					vy[y][x] += dy*AIR_TSTEPV;
+					if (bmap_blockair[y][x] || bmap_blockair[y][x+1])
+						vx[y][x] = 0;
+					if (bmap_blockair[y][x] || bmap_blockair[y+1][x])
+						vy[y][x] = 0;
+				}
+		});
+
+		ThreadPool::Ref().ParallelFor(0, YRES/CELL, rowsPerJob, [this](int rowBegin, int rowEnd) {
+			update_air_rows(rowBegin, rowEnd);
+		});
+		memcpy(vx, ovx, sizeof(vx));
+		memcpy(vy, ovy, sizeof(vy));
+		memcpy(pv, opv, sizeof(pv));
+	}
+}
+
+void Air::update_air_rows(int rowBegin, int rowEnd)
+{
+	int x = 0, y = 0, i = 0, j = 0;
+	float dp = 0.0f, dx = 0.0f, dy = 0.0f, f = 0.0f, tx = 0.0f, ty = 0.0f;
+	const float advDistanceMult = 0.7f;
+	float stepX, stepY;
+	int stepLimit, step;
+
+	for (y=rowBegin; y<rowEnd; y++) //update velocity and pressure
+		for (x=0; x<XRES/CELL; x++)
+		{
+			dx = 0.0f;
+			dy = 0.0f;
+			dp = 0.0f;
+			for (j=-1; j<2; j++)
+				for (i=-1; i<2; i++)
+					if (y+j>0 && y+j<YRES/CELL-1 &&
+					        x+i>0 && x+i<XRES/CELL-1 &&
+					        !bmap_blockair[y+j][x+i])
 					{
-						stepX = (dx<0.0f) ? 1.f : -1.f;
-						stepY = -dy/fabsf(dx);
-						stepLimit = (int)(fabsf(dx*advDistanceMult));
+						f = kernel[i+1+(j+1)*3];
+						dx += vx[y+j][x+i]*f;
+						dy += vy[y+j][x+i]*f;
+						dp += pv[y+j][x+i]*f;
 					}
 					else
 					{
-						stepY = (dy<0.0f) ? 1.f : -1.f;
-						stepX = -dx/fabsf(dy);
-						stepLimit = (int)(fabsf(dy*advDistanceMult));
-					}
-					tx = float(x);
-					ty = float(y);
-					for (step=0; step<stepLimit; ++step)
-					{
-						tx += stepX;
-						ty += stepY;
-						if (bmap_blockair[(int)(ty+0.5f)][(int)(tx+0.5f)])
-						{
-							tx -= stepX;
-							ty -= stepY;
-							break;
-						}
+						f = kernel[i+1+(j+1)*3];
+						dx += vx[y][x]*f;
+						dy += vy[y][x]*f;
+						dp += pv[y][x]*f;
 					}
-					if (step==stepLimit)
+
+			tx = x - dx*advDistanceMult;
+			ty = y - dy*advDistanceMult;
+			if ((dx*advDistanceMult>1.0f || dy*advDistanceMult>1.0f) && (tx>=2 && tx<XRES/CELL-2 && ty>=2 && ty<YRES/CELL-2))
+			{
+				// Trying to take velocity from far away, check whether there is an intervening wall. Step from current position to desired source location, looking for walls, with either the x or y step size being 1 cell
+				if (std::abs(dx)>std::abs(dy))
+				{
+					stepX = (dx<0.0f) ? 1.f : -1.f;
+					stepY = -dy/fabsf(dx);
+					stepLimit = (int)(fabsf(dx*advDistanceMult));
+				}
+				else
+				{
+					stepY = (dy<0.0f) ? 1.f : -1.f;
+					stepX = -dx/fabsf(dy);
+					stepLimit = (int)(fabsf(dy*advDistanceMult));
+				}
+				tx = float(x);
+				ty = float(y);
+				for (step=0; step<stepLimit; ++step)
+				{
+					tx += stepX;
+					ty += stepY;
+					if (bmap_blockair[(int)(ty+0.5f)][(int)(tx+0.5f)])
 					{
-						// No wall found
-						tx = x - dx*advDistanceMult;
-						ty = y - dy*advDistanceMult;
+						tx -= stepX;
+						ty -= stepY;
+						break;
 					}
 				}
-				i = (int)tx;
-				j = (int)ty;
-				tx -= i;
-				ty -= j;
-				if (!bmap_blockair[y][x] && i>=2 && i<=XRES/CELL-3 &&
-				        j>=2 && j<=YRES/CELL-3)
+				if (step==stepLimit)
 				{
-					dx *= 1.0f - AIR_VADV;
-					dy *= 1.0f - AIR_VADV;
-
-					dx += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vx[j][i];
-					dy += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vy[j][i];
+					// No wall found
+					tx = x - dx*advDistanceMult;
+					ty = y - dy*advDistanceMult;
+				}
+			}
+			i = (int)tx;
+			j = (int)ty;
+			tx -= i;
+			ty -= j;
+			if (!bmap_blockair[y][x] && i>=2 && i<=XRES/CELL-3 &&
+			        j>=2 && j<=YRES/CELL-3)
+			{
+				dx *= 1.0f - AIR_VADV;
+				dy *= 1.0f - AIR_VADV;
 
-					dx += AIR_VADV*tx*(1.0f-ty)*vx[j][i+1];
-					dy += AIR_VADV*tx*(1.0f-ty)*vy[j][i+1];
+				dx += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vx[j][i];
+				dy += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vy[j][i];
 
-					dx += AIR_VADV*(1.0f-tx)*ty*vx[j+1][i];
-					dy += AIR_VADV*(1.0f-tx)*ty*vy[j+1][i];
+				dx += AIR_VADV*tx*(1.0f-ty)*vx[j][i+1];
+				dy += AIR_VADV*tx*(1.0f-ty)*vy[j][i+1];
 
-					dx += AIR_VADV*tx*ty*vx[j+1][i+1];
-					dy += AIR_VADV*tx*ty*vy[j+1][i+1];
-				}
+				dx += AIR_VADV*(1.0f-tx)*ty*vx[j+1][i];
+				dy += AIR_VADV*(1.0f-tx)*ty*vy[j+1][i];
 
-				if (bmap[y][x] == WL_FAN)
-				{
-					dx += fvx[y][x];
-					dy += fvy[y][x];
-				}
-				// pressure/velocity caps
-				if (dp > 256.0f) dp = 256.0f;
-				if (dp < -256.0f) dp = -256.0f;
-				if (dx > 256.0f) dx = 256.0f;
-				if (dx < -256.0f) dx = -256.0f;
-				if (dy > 256.0f) dy = 256.0f;
-				if (dy < -256.0f) dy = -256.0f;
+				dx += AIR_VADV*tx*ty*vx[j+1][i+1];
+				dy += AIR_VADV*tx*ty*vy[j+1][i+1];
+			}
 
+			if (bmap[y][x] == WL_FAN)
+			{
+				dx += fvx[y][x];
+				dy += fvy[y][x];
+			}
+			// pressure/velocity caps
+			if (dp > 256.0f) dp = 256.0f;
+			if (dp < -256.0f) dp = -256.0f;
+			if (dx > 256.0f) dx = 256.0f;
+			if (dx < -256.0f) dx = -256.0f;
+			if (dy > 256.0f) dy = 256.0f;
+			if (dy < -256.0f) dy = -256.0f;
 
-				switch (airMode)
-				{
-				default:
-				case 0:  //Default
-					break;
-				case 1:  //0 Pressure
-					dp = 0.0f;
-					break;
-				case 2:  //0 Velocity
-					dx = 0.0f;
-					dy = 0.0f;
-					break;
-				case 3: //0 Air
-					dx = 0.0f;
-					dy = 0.0f;
-					dp = 0.0f;
-					break;
-				case 4: //No Update
-					break;
-				}
 
-				ovx[y][x] = dx;
-				ovy[y][x] = dy;
-				opv[y][x] = dp;
+			switch (airMode)
+			{
+			default:
+			case 0:  //Default
+				break;
+			case 1:  //0 Pressure
+				dp = 0.0f;
+				break;
+			case 2:  //0 Velocity
+				dx = 0.0f;
+				dy = 0.0f;
+				break;
+			case 3: //0 Air
+				dx = 0.0f;
+				dy = 0.0f;
+				dp = 0.0f;
+				break;
+			case 4: //No Update
+				break;
 			}
-		memcpy(vx, ovx, sizeof(vx));
-		memcpy(vy, ovy, sizeof(vy));
-		memcpy(pv, opv, sizeof(pv));
-	}
+
+			ovx[y][x] = dx;
+			ovy[y][x] = dy;
+			opv[y][x] = dp;
+		}
 }
 
 void Air::Invert()
@@ -373,7 +413,7 @@ void Air::RecalculateBlockAirMaps()
 			}
 		}
 		// mostly accurate insulator blocking, besides checking GEL
-		else if ((type == PT_HSWC && sim.parts[i].life != 10) || sim.elements[type].HeatConduct <= (random_gen()%250))
+		else if ((type == PT_HSWC && sim.parts[i].life != 10) || sim.elements[type].HeatConduct <= (sim.rng()%250))
 		{
 			int x = ((int)(sim.parts[i].x+0.5f))/CELL, y = ((int)(sim.parts[i].y+0.5f))/CELL;
 			if (sim.InBounds(x, y) && !(bmap_blockairh[y][x]&0x8))
@@ -399,4 +439,5 @@ Air::Air(Simulation & simulation):
 	std::fill(&ohv[0][0], &ohv[0][0]+((XRES/CELL)*(YRES/CELL)), 0.0f);
 	std::fill(&pv[0][0], &pv[0][0]+((XRES/CELL)*(YRES/CELL)), 0.0f);
 	std::fill(&opv[0][0], &opv[0][0]+((XRES/CELL)*(YRES/CELL)), 0.0f);
+	std::fill(&risenvy[0][0], &risenvy[0][0]+((XRES/CELL)*(YRES/CELL)), 0.0f);
 }
@@ -27,9 +27,15 @@ public:
 	unsigned char bmap_blockair[YRES/CELL][XRES/CELL];
 	unsigned char bmap_blockairh[YRES/CELL][XRES/CELL];
 	float kernel[9];
+	// vy after hot air has risen, read by the ambient heat update
+	float risenvy[YRES/CELL][XRES/CELL];
+	// rows of the grid handed to each worker thread at a time
+	static constexpr int rowsPerJob = 4;
 	void make_kernel(void);
 	void update_airh(void);
+	void update_airh_rows(int rowBegin, int rowEnd);
 	void update_air(void);
+	void update_air_rows(int rowBegin, int rowEnd);
 	void Clear();
 	void ClearAirH();
 	void Invert();
@@ -105,15 +105,15 @@ int Element::legacyUpdate(UPDATE_FUNC_ARGS) {
 					r = pmap[y+ry][x+rx];
 					if (!r)
 						continue;
-					if ((TYP(r)==PT_WATR||TYP(r)==PT_DSTW||TYP(r)==PT_SLTW) && RNG::Ref().chance(1, 1000))
+					if ((TYP(r)==PT_WATR||TYP(r)==PT_DSTW||TYP(r)==PT_SLTW) && sim->rng.chance(1, 1000))
 					{
 						sim->part_change_type(i,x,y,PT_WATR);
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_WATR);
 					}
-					if ((TYP(r)==PT_ICEI || TYP(r)==PT_SNOW) && RNG::Ref().chance(1, 1000))
+					if ((TYP(r)==PT_ICEI || TYP(r)==PT_SNOW) && sim->rng.chance(1, 1000))
 					{
 						sim->part_change_type(i,x,y,PT_WATR);
-						if (RNG::Ref().chance(1, 1000))
+						if (sim->rng.chance(1, 1000))
 							sim->part_change_type(ID(r),x+rx,y+ry,PT_WATR);
 					}
 				}
@@ -127,7 +127,7 @@ int Element::legacyUpdate(UPDATE_FUNC_ARGS) {
 					r = pmap[y+ry][x+rx];
 					if (!r)
 						continue;
-					if ((TYP(r)==PT_FIRE || TYP(r)==PT_LAVA) && RNG::Ref().chance(1, 10))
+					if ((TYP(r)==PT_FIRE || TYP(r)==PT_LAVA) && sim->rng.chance(1, 10))
 					{
 						sim->part_change_type(i,x,y,PT_WTRV);
 					}
@@ -142,9 +142,9 @@ int Element::legacyUpdate(UPDATE_FUNC_ARGS) {
 					r = pmap[y+ry][x+rx];
 					if (!r)
 						continue;
-					if ((TYP(r)==PT_FIRE || TYP(r)==PT_LAVA) && RNG::Ref().chance(1, 10))
+					if ((TYP(r)==PT_FIRE || TYP(r)==PT_LAVA) && sim->rng.chance(1, 10))
 					{
-						if (RNG::Ref().chance(1, 4))
+						if (sim->rng.chance(1, 4))
 							sim->part_change_type(i,x,y,PT_SALT);
 						else
 							sim->part_change_type(i,x,y,PT_WTRV);
@@ -160,7 +160,7 @@ int Element::legacyUpdate(UPDATE_FUNC_ARGS) {
 					r = pmap[y+ry][x+rx];
 					if (!r)
 						continue;
-					if ((TYP(r)==PT_FIRE || TYP(r)==PT_LAVA) && RNG::Ref().chance(1, 10))
+					if ((TYP(r)==PT_FIRE || TYP(r)==PT_LAVA) && sim->rng.chance(1, 10))
 					{
 						sim->part_change_type(i,x,y,PT_WTRV);
 					}
@@ -174,7 +174,7 @@ int Element::legacyUpdate(UPDATE_FUNC_ARGS) {
 					r = pmap[y+ry][x+rx];
 					if (!r)
 						continue;
-					if ((TYP(r)==PT_WATR || TYP(r)==PT_DSTW) && RNG::Ref().chance(1, 1000))
+					if ((TYP(r)==PT_WATR || TYP(r)==PT_DSTW) && sim->rng.chance(1, 1000))
 					{
 						sim->part_change_type(i,x,y,PT_ICEI);
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_ICEI);
@@ -189,12 +189,12 @@ int Element::legacyUpdate(UPDATE_FUNC_ARGS) {
 					r = pmap[y+ry][x+rx];
 					if (!r)
 						continue;
-					if ((TYP(r)==PT_WATR || TYP(r)==PT_DSTW) && RNG::Ref().chance(1, 1000))
+					if ((TYP(r)==PT_WATR || TYP(r)==PT_DSTW) && sim->rng.chance(1, 1000))
 					{
 						sim->part_change_type(i,x,y,PT_ICEI);
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_ICEI);
 					}
-					if ((TYP(r)==PT_WATR || TYP(r)==PT_DSTW) && RNG::Ref().chance(3, 200))
+					if ((TYP(r)==PT_WATR || TYP(r)==PT_DSTW) && sim->rng.chance(3, 200))
 						sim->part_change_type(i,x,y,PT_WATR);
 				}
 	}
@@ -207,7 +207,7 @@ int Element::legacyUpdate(UPDATE_FUNC_ARGS) {
 	if (t==PT_DESL && sim->pv[y/CELL][x/CELL]>12.0f)
 	{
 		sim->part_change_type(i,x,y,PT_FIRE);
-		parts[i].life = RNG::Ref().between(120, 169);
+		parts[i].life = sim->rng.between(120, 169);
 	}
 	return 0;
 }
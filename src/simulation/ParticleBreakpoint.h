@@ -0,0 +1,41 @@
+#ifndef PARTICLEBREAKPOINT_H
+#define PARTICLEBREAKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// A condition Simulation::StepParticles stops the particle loop at. Id, Type and
+// Position are checked against a particle right before it is updated; Property,
+// PropertyAt and InterestingChange are checked against what the particles updated
+// so far did. Property and PropertyAt act as watchpoints: they are also checked
+// outside StepParticles, and every change they see is recorded as a
+// ParticleBreakpointHit.
+struct ParticleBreakpoint
+{
+	enum Kind
+	{
+		Id,                // the particle with this id is next
+		Type,              // a particle of this type is next
+		Position,          // a particle at x, y is next
+		Property,          // a property of the particle with this id changed
+		PropertyAt,        // a property of the particle at x, y changed
+		InterestingChange, // something set debug_interestingChangeOccurred
+	};
+
+	Kind kind;
+	int value;          // particle id for Id and Property, element for Type
+	int x, y;           // Position and PropertyAt only
+	size_t offset;      // Property and PropertyAt only, offset of the property in Particle
+	uint32_t lastValue; // Property and PropertyAt only, what the property was when last checked
+};
+
+struct ParticleBreakpointHit
+{
+	int particle;       // the particle whose property changed
+	size_t offset;
+	uint32_t oldValue, newValue;
+	int writer;         // the particle whose update changed it
+	int writerType;     // the type of the writer when its update started
+};
+
+#endif
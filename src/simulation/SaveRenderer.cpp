@@ -7,14 +7,18 @@
 
 #include "Simulation.h"
 
-SaveRenderer::SaveRenderer(){
-	g = new Graphics();
-	sim = new Simulation();
-	ren = new Renderer(g, sim);
-	ren->decorations_enable = true;
-	ren->blackDecorations = true;
+#include <algorithm>
+#include <thread>
+
+SaveRenderer::SaveRenderer():
+	contextCount(1)
+{
+	freeContexts.push_back(NewContext());
 
 #if defined(OGLR) || defined(OGLI)
+	// there is only the one framebuffer to render to
+	maxContexts = 1;
+
 	glEnable(GL_TEXTURE_2D);
 	glGenTextures(1, &fboTex);
 	glBindTexture(GL_TEXTURE_2D, fboTex);
@@ -30,12 +34,69 @@ SaveRenderer::SaveRenderer(){
 	glBindTexture(GL_TEXTURE_2D, 0);
 	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0); // Reset framebuffer binding
 	glDisable(GL_TEXTURE_2D);
+#else
+	maxContexts = std::max(std::min(int(std::thread::hardware_concurrency()), 4), 1);
 #endif
 }
 
+SaveRenderer::Context * SaveRenderer::NewContext()
+{
+	auto * context = new Context;
+	context->g = new Graphics();
+	context->sim = new Simulation();
+	context->ren = new Renderer(context->g, context->sim);
+	context->ren->decorations_enable = true;
+	context->ren->blackDecorations = true;
+	return context;
+}
+
+SaveRenderer::Context * SaveRenderer::AcquireContext()
+{
+	std::unique_lock<std::mutex> lock(renderMutex);
+	contextFreed.wait(lock, [this] { return freeContexts.size() || contextCount < maxContexts; });
+	if (freeContexts.size())
+	{
+		auto * context = freeContexts.back();
+		freeContexts.pop_back();
+		return context;
+	}
+	contextCount++;
+	// creating a Simulation takes a while, let other threads get at the free list meanwhile
+	lock.unlock();
+	return NewContext();
+}
+
+void SaveRenderer::ReleaseContext(Context * context)
+{
+	{
+		std::lock_guard<std::mutex> lock(renderMutex);
+		freeContexts.push_back(context);
+	}
+	contextFreed.notify_one();
+}
+
 VideoBuffer * SaveRenderer::Render(GameSave * save, bool decorations, bool fire, Renderer *renderModeSource)
 {
-	std::lock_guard<std::mutex> gx(renderMutex);
+	auto * context = AcquireContext();
+	VideoBuffer * thumb;
+	try
+	{
+		thumb = Render(*context, save, decorations, fire, renderModeSource);
+	}
+	catch (...)
+	{
+		ReleaseContext(context);
+		throw;
+	}
+	ReleaseContext(context);
+	return thumb;
+}
+
+VideoBuffer * SaveRenderer::Render(Context & context, GameSave * save, bool decorations, bool fire, Renderer *renderModeSource)
+{
+	auto * g = context.g;
+	auto * sim = context.sim;
+	auto * ren = context.ren;
 
 	ren->ResetModes();
 	if (renderModeSource)
@@ -161,8 +222,6 @@ VideoBuffer * SaveRenderer::Render(GameSave * save, bool decorations, bool fire,
 
 VideoBuffer * SaveRenderer::Render(unsigned char * saveData, int dataSize, bool decorations, bool fire)
 {
-	std::lock_guard<std::mutex> g(renderMutex);
-
 	GameSave * tempSave;
 	try {
 		tempSave = new GameSave((char*)saveData, dataSize);
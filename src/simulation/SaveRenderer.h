@@ -5,7 +5,9 @@
 #include "graphics/OpenGLHeaders.h"
 #endif
 #include "common/Singleton.h"
+#include <condition_variable>
 #include <mutex>
+#include <vector>
 
 class GameSave;
 class VideoBuffer;
@@ -14,10 +16,24 @@ class Simulation;
 class Renderer;
 
 class SaveRenderer: public Singleton<SaveRenderer> {
-	Graphics * g;
-	Simulation * sim;
-	Renderer * ren;
+	// What a save is rendered with. Render takes a free one, or creates a new one if there
+	// are fewer than maxContexts, so that many saves can be rendered at the same time.
+	struct Context
+	{
+		Graphics * g;
+		Simulation * sim;
+		Renderer * ren;
+	};
+	int maxContexts;
+	int contextCount;
+	std::vector<Context *> freeContexts;
 	std::mutex renderMutex;
+	std::condition_variable contextFreed;
+
+	Context * NewContext();
+	Context * AcquireContext();
+	void ReleaseContext(Context * context);
+	VideoBuffer * Render(Context & context, GameSave * save, bool decorations, bool fire, Renderer *renderModeSource);
 public:
 	SaveRenderer();
 	VideoBuffer * Render(GameSave * save, bool decorations = true, bool fire = true, Renderer *renderModeSource = nullptr);
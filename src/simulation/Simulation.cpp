@@ -43,6 +43,53 @@ extern int Element_LOLZ_lolz[XRES/9][YRES/9];
 extern int Element_LOVE_RuleTable[9][9];
 extern int Element_LOVE_love[XRES/9][YRES/9];
 
+// Subframe order compares particles by row, then by column
+static int64_t SubframeOrderKey(const Particle &part)
+{
+	int x = int(part.x + 0.5f);
+	int y = int(part.y + 0.5f);
+	return (int64_t(y) << 32) + x;
+}
+
+// subframeOrderKey value for empty slots
+static const int64_t noSubframeOrderKey = INT64_MIN;
+
+// how far UpdateSubframeOrder looks for the particles on either side before giving up
+// and leaving the count to be recomputed
+static const int subframeOrderSearchLimit = 256;
+
+// Hashes a block of memory eight bytes at a time into four independent lanes, so the
+// multiplications don't wait on each other. Not cryptographic in the slightest, just
+// good enough to tell two runs apart.
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+	constexpr uint64_t multiplier = UINT64_C(0x9E3779B97F4A7C15);
+	auto *bytes = reinterpret_cast<const unsigned char *>(data);
+	uint64_t lanes[4] = { hash, hash ^ 1, hash ^ 2, hash ^ 3 };
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		for (int lane = 0; lane < 4; lane++)
+		{
+			uint64_t word;
+			std::memcpy(&word, bytes + i + lane * 8, sizeof(word));
+			lanes[lane] = (lanes[lane] ^ word) * multiplier;
+			lanes[lane] ^= lanes[lane] >> 32;
+		}
+	}
+	for (; i < size; i++)
+	{
+		lanes[0] = (lanes[0] ^ bytes[i]) * multiplier;
+		lanes[0] ^= lanes[0] >> 32;
+	}
+	for (int lane = 0; lane < 4; lane++)
+	{
+		hash = (hash ^ lanes[lane]) * multiplier;
+		hash ^= hash >> 32;
+	}
+	return (hash ^ size) * multiplier;
+}
+
 int Simulation::Load(const GameSave * save, bool includePressure)
 {
 	return Load(save, includePressure, 0, 0);
@@ -52,17 +99,25 @@ int Simulation::Load(const GameSave * originalSave, bool includePressure, int fu
 {
 	if (!originalSave)
 		return 1;
-	auto save = std::unique_ptr<GameSave>(new GameSave(*originalSave));
-	try
-	{
-		save->Expand();
-	}
-	catch (const ParseException &e)
+	// An expanded save is read in place, nothing below modifies it. A collapsed one has to be
+	// parsed, which only needs a copy of its original data, not of the save.
+	std::unique_ptr<GameSave> expandedSave;
+	const GameSave *save = originalSave;
+	if (originalSave->Collapsed())
 	{
+		try
+		{
+			expandedSave = std::unique_ptr<GameSave>(new GameSave(*originalSave));
+			expandedSave->Expand();
+		}
+		catch (const ParseException &e)
+		{
 #ifdef LUACONSOLE
-		luacon_ci->SetLastError(ByteString(e.what()).FromUtf8());
+			luacon_ci->SetLastError(ByteString(e.what()).FromUtf8());
 #endif
-		return 1;
+			return 1;
+		}
+		save = expandedSave.get();
 	}
 
 	//Align to blockMap
@@ -100,47 +155,49 @@ int Simulation::Load(const GameSave * originalSave, bool includePressure, int fu
 
 	int r;
 	bool doFullScan = false;
+	// particles that can't be spawned, for whatever reason, are skipped when allocating below
+	std::vector<char> blocked(std::min(NPART, save->particlesCount), 0);
 	for (int n = 0; n < NPART && n < save->particlesCount; n++)
 	{
-		Particle *tempPart = &save->particles[n];
-		tempPart->x += (float)fullX;
-		tempPart->y += (float)fullY;
-		int x = int(tempPart->x + 0.5f);
-		int y = int(tempPart->y + 0.5f);
+		const Particle *tempPart = &save->particles[n];
+		float partX = tempPart->x + (float)fullX;
+		float partY = tempPart->y + (float)fullY;
+		int x = int(partX + 0.5f);
+		int y = int(partY + 0.5f);
 
-		// Check various scenarios where we are unable to spawn the element, and set type to 0 to block spawning later
+		// Check various scenarios where we are unable to spawn the element, and block spawning later
 		if (!InBounds(x, y))
 		{
-			tempPart->type = 0;
+			blocked[n] = 1;
 			continue;
 		}
 
 		int type = tempPart->type;
 		if (type < 0 && type >= PT_NUM)
 		{
-			tempPart->type = 0;
+			blocked[n] = 1;
 			continue;
 		}
 		// Ensure we can spawn this element
 		if ((player.spwn == 1 && tempPart->type==PT_STKM) || (player2.spwn == 1 && tempPart->type==PT_STKM2))
 		{
-			tempPart->type = 0;
+			blocked[n] = 1;
 			continue;
 		}
 		if ((tempPart->type == PT_SPAWN || tempPart->type == PT_SPAWN2) && elementCount[type])
 		{
-			tempPart->type = 0;
+			blocked[n] = 1;
 			continue;
 		}
 		bool Element_FIGH_CanAlloc(Simulation *sim);
 		if (tempPart->type == PT_FIGH && !Element_FIGH_CanAlloc(this))
 		{
-			tempPart->type = 0;
+			blocked[n] = 1;
 			continue;
 		}
 		if (!elements[type].Enabled)
 		{
-			tempPart->type = 0;
+			blocked[n] = 1;
 			continue;
 		}
 
@@ -184,11 +241,15 @@ int Simulation::Load(const GameSave * originalSave, bool includePressure, int fu
 	RecalcFreeParticles(false);
 
 	int i;
-	// Map of soap particles loaded into this save, old ID -> new ID
-	std::map<unsigned int, unsigned int> soapList;
+	// soap particles loaded into this save, old ID -> new ID
+	std::vector<int> soapRemap(std::min(NPART, save->particlesCount), -1);
 	for (int n = 0; n < NPART && n < save->particlesCount; n++)
 	{
+		if (blocked[n])
+			continue;
 		Particle tempPart = save->particles[n];
+		tempPart.x += (float)fullX;
+		tempPart.y += (float)fullY;
 		if (tempPart.type > 0 && tempPart.type < PT_NUM)
 			tempPart.type = partMap[tempPart.type];
 		else
@@ -307,7 +368,7 @@ int Simulation::Load(const GameSave * originalSave, bool includePressure, int fu
 			break;
 		}
 		case PT_SOAP:
-			soapList.insert(std::pair<unsigned int, unsigned int>(n, i));
+			soapRemap[n] = i;
 			break;
 		}
 		if (GameSave::PressureInTmp3(parts[i].type) && !includePressure)
@@ -318,7 +379,8 @@ int Simulation::Load(const GameSave * originalSave, bool includePressure, int fu
 	force_stacking_check = true;
 	Element_PPIP_ppip_changed = 1;
 
-	FixSoapLinks(soapList);
+	FixSoapLinks(soapRemap);
+	subframeOrderStale = true;
 
 	for (size_t i = 0; i < save->signs.size() && signs.size() < MAXSIGNS; i++)
 	{
@@ -358,6 +420,12 @@ int Simulation::Load(const GameSave * originalSave, bool includePressure, int fu
 		}
 	}
 
+	// only whole saves carry over the random number generator, pasting a stamp shouldn't reseed it
+	if (save->hasRngState && !blockX && !blockY && save->blockWidth == XRES/CELL && save->blockHeight == YRES/CELL)
+	{
+		rng.state(save->rngState);
+	}
+
 	gravWallChanged = true;
 	air->RecalculateBlockAirMaps();
 
@@ -521,6 +589,8 @@ GameSave * Simulation::Save(bool includePressure, int fullX, int fullY, int full
 
 	SaveSimOptions(newSave);
 	newSave->pmapbits = PMAPBITS;
+	newSave->hasRngState = true;
+	newSave->rngState = rng.state();
 	return newSave;
 }
 
@@ -538,28 +608,34 @@ void Simulation::SaveSimOptions(GameSave * gameSave)
 	gameSave->aheatEnable = aheat_enable;
 }
 
-std::unique_ptr<Snapshot> Simulation::CreateSnapshot()
+std::unique_ptr<Snapshot> Simulation::CreateSnapshot(std::unique_ptr<Snapshot> reuse)
 {
-	auto snap = std::make_unique<Snapshot>();
-	snap->AirPressure    .insert   (snap->AirPressure    .begin(), &pv  [0][0]      , &pv  [0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->AirVelocityX   .insert   (snap->AirVelocityX   .begin(), &vx  [0][0]      , &vx  [0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->AirVelocityY   .insert   (snap->AirVelocityY   .begin(), &vy  [0][0]      , &vy  [0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->AmbientHeat    .insert   (snap->AmbientHeat    .begin(), &hv  [0][0]      , &hv  [0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->BlockMap       .insert   (snap->BlockMap       .begin(), &bmap[0][0]      , &bmap[0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->ElecMap        .insert   (snap->ElecMap        .begin(), &emap[0][0]      , &emap[0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->FanVelocityX   .insert   (snap->FanVelocityX   .begin(), &fvx [0][0]      , &fvx [0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->FanVelocityY   .insert   (snap->FanVelocityY   .begin(), &fvy [0][0]      , &fvy [0][0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->GravVelocityX  .insert   (snap->GravVelocityX  .begin(), &gravx  [0]      , &gravx  [0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->GravVelocityY  .insert   (snap->GravVelocityY  .begin(), &gravy  [0]      , &gravy  [0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->GravValue      .insert   (snap->GravValue      .begin(), &gravp  [0]      , &gravp  [0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->GravMap        .insert   (snap->GravMap        .begin(), &gravmap[0]      , &gravmap[0] + ((XRES / CELL) * (YRES / CELL)));
-	snap->Particles      .insert   (snap->Particles      .begin(), &parts  [0]      , &parts[parts_lastActiveIndex + 1]            );
-	snap->PortalParticles.insert   (snap->PortalParticles.begin(), &portalp[0][0][0], &portalp [CHANNELS - 1][8 - 1][80 - 1]       );
-	snap->WirelessData   .insert   (snap->WirelessData   .begin(), &wireless[0][0]  , &wireless[CHANNELS - 1][2 - 1]               );
-	snap->stickmen       .insert   (snap->stickmen       .begin(), &fighters[0]     , &fighters[MAX_FIGHTERS]                      );
+	// * Overwriting a Snapshot that is no longer needed is a lot cheaper than allocating (and
+	//   thus faulting in) fresh memory for a new one, especially when there are many particles.
+	//   Every array is still copied in full, though, and SnapshotDelta::FromSnapshots still
+	//   compares all of it, so on large saves a snapshot is cheaper than it was but not free.
+	auto snap = reuse ? std::move(reuse) : std::make_unique<Snapshot>();
+	snap->AirPressure    .assign   (&pv  [0][0]      , &pv  [0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->AirVelocityX   .assign   (&vx  [0][0]      , &vx  [0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->AirVelocityY   .assign   (&vy  [0][0]      , &vy  [0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->AmbientHeat    .assign   (&hv  [0][0]      , &hv  [0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->BlockMap       .assign   (&bmap[0][0]      , &bmap[0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->ElecMap        .assign   (&emap[0][0]      , &emap[0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->FanVelocityX   .assign   (&fvx [0][0]      , &fvx [0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->FanVelocityY   .assign   (&fvy [0][0]      , &fvy [0][0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->GravVelocityX  .assign   (&gravx  [0]      , &gravx  [0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->GravVelocityY  .assign   (&gravy  [0]      , &gravy  [0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->GravValue      .assign   (&gravp  [0]      , &gravp  [0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->GravMap        .assign   (&gravmap[0]      , &gravmap[0] + ((XRES / CELL) * (YRES / CELL)));
+	snap->Particles      .assign   (&parts  [0]      , &parts[parts_lastActiveIndex + 1]            );
+	snap->PortalParticles.assign   (&portalp[0][0][0], &portalp [CHANNELS - 1][8 - 1][80 - 1]       );
+	snap->WirelessData   .assign   (&wireless[0][0]  , &wireless[CHANNELS - 1][2 - 1]               );
+	snap->stickmen       .assign   (&fighters[0]     , &fighters[MAX_FIGHTERS]                      );
 	snap->stickmen       .push_back(player2);
 	snap->stickmen       .push_back(player);
 	snap->signs = signs;
+	snap->Authors = Json::Value();
+	snap->RngState = rng.state();
 	snap->debug_currentParticle = debug_currentParticle;
 	return snap;
 }
@@ -596,6 +672,7 @@ void Simulation::Restore(const Snapshot &snap)
 	player  = snap.stickmen[snap.stickmen.size() - 1];
 	player2 = snap.stickmen[snap.stickmen.size() - 2];
 	signs = snap.signs;
+	rng.state(snap.RngState);
 	parts_lastActiveIndex = NPART - 1;
 	air->RecalculateBlockAirMaps();
 	RecalcFreeParticles(false);
@@ -604,6 +681,32 @@ void Simulation::Restore(const Snapshot &snap)
 	needReloadParticleOrder = true;
 }
 
+void Simulation::CopyRenderState(const Simulation &source)
+{
+	// reuses the storage of the strings in here, so this doesn't allocate after the first copy
+	elements = source.elements;
+	currentTick = source.currentTick;
+	parts_lastActiveIndex = source.parts_lastActiveIndex;
+	std::copy(source.parts, source.parts + parts_lastActiveIndex + 1, parts);
+	std::copy(&source.pmap[0][0], &source.pmap[0][0] + YRES * XRES, &pmap[0][0]);
+	std::copy(&source.photons[0][0], &source.photons[0][0] + YRES * XRES, &photons[0][0]);
+	std::copy(&source.bmap[0][0], &source.bmap[0][0] + (YRES/CELL) * (XRES/CELL), &bmap[0][0]);
+	std::copy(&source.emap[0][0], &source.emap[0][0] + (YRES/CELL) * (XRES/CELL), &emap[0][0]);
+	std::copy(&source.pv[0][0], &source.pv[0][0] + (YRES/CELL) * (XRES/CELL), &pv[0][0]);
+	std::copy(&source.vx[0][0], &source.vx[0][0] + (YRES/CELL) * (XRES/CELL), &vx[0][0]);
+	std::copy(&source.vy[0][0], &source.vy[0][0] + (YRES/CELL) * (XRES/CELL), &vy[0][0]);
+	std::copy(&source.hv[0][0], &source.hv[0][0] + (YRES/CELL) * (XRES/CELL), &hv[0][0]);
+	std::copy(source.gravx, source.gravx + (YRES/CELL) * (XRES/CELL), gravx);
+	std::copy(source.gravy, source.gravy + (YRES/CELL) * (XRES/CELL), gravy);
+	std::copy(source.grav->gravmask, source.grav->gravmask + (YRES/CELL) * (XRES/CELL), grav->gravmask);
+	signs = source.signs;
+	player = source.player;
+	player2 = source.player2;
+	std::copy(source.fighters, source.fighters + MAX_FIGHTERS, fighters);
+	emp_decor = source.emp_decor;
+	aheat_enable = source.aheat_enable;
+}
+
 void Simulation::clear_area(int area_x, int area_y, int area_w, int area_h)
 {
 	float fx = area_x-.5f, fy = area_y-.5f;
@@ -974,7 +1077,7 @@ bool Simulation::flood_water(int x, int y, int i)
 				if ((y - 1) > originalY && !pmap[y - 1][x])
 				{
 					// Try to move the water to a random position on this line, because there's probably a free location somewhere
-					int randPos = RNG::Ref().between(x, x2);
+					int randPos = rng.between(x, x2);
 					if (!pmap[y - 1][randPos] && eval_move(parts[i].type, randPos, y - 1, nullptr))
 						x = randPos;
 					// Couldn't move to random position, so try the original position on the left
@@ -985,8 +1088,11 @@ bool Simulation::flood_water(int x, int y, int i)
 					int oldy = (int)(parts[i].y + 0.5f);
 					pmap[y - 1][x] = pmap[oldy][oldx];
 					pmap[oldy][oldx] = 0;
+					MarkPmapDirty(x, y - 1);
+					MarkPmapDirty(oldx, oldy);
 					parts[i].x = float(x);
 					parts[i].y = float(y - 1);
+					UpdateSubframeOrder(i);
 					return true;
 				}
 
@@ -2204,7 +2310,7 @@ int Simulation::get_wavelength_bin(int *wm)
 	if (wM - w0 < 5)
 		return wM + w0;
 
-	r = RNG::Ref().gen();
+	r = rng.gen();
 	i = (r >> 1) % (wM-w0-4);
 	i += w0;
 
@@ -2328,8 +2434,8 @@ void Simulation::create_arc(int sx, int sy, int dx, int dy, int midpoints, int v
 	{
 		if(i!=midpoints)
 		{
-			xmid[i+1] += RNG::Ref().between(0, variance - 1) - voffset;
-			ymid[i+1] += RNG::Ref().between(0, variance - 1) - voffset;
+			xmid[i+1] += rng.between(0, variance - 1) - voffset;
+			ymid[i+1] += rng.between(0, variance - 1) - voffset;
 		}
 		CreateLine(xmid[i], ymid[i], xmid[i+1], ymid[i+1], type);
 	}
@@ -2348,12 +2454,17 @@ void Simulation::clear_sim(void)
 	memset(bmap, 0, sizeof(bmap));
 	memset(emap, 0, sizeof(emap));
 	memset(parts, 0, sizeof(Particle)*NPART);
+	std::fill(partsType, partsType+NPART, 0);
 	for (int i = 0; i < NPART-1; i++)
 		parts[i].life = i+1;
 	parts[NPART-1].life = -1;
 	pfree = 0;
 	parts_lastActiveIndex = 0;
+	std::fill(subframeOrderKey, subframeOrderKey+NPART, noSubframeOrderKey);
+	subframeOrderBreaks = 0;
+	subframeOrderStale = false;
 	memset(pmap, 0, sizeof(pmap));
+	pmapDirtyAll = true;
 	memset(fvx, 0, sizeof(fvx));
 	memset(fvy, 0, sizeof(fvy));
 	memset(photons, 0, sizeof(photons));
@@ -2411,6 +2522,8 @@ bool Simulation::IsWallBlocking(int x, int y, int type)
 
 void Simulation::init_can_move()
 {
+	// called when element properties change, which can move existing particles between pmap and photons
+	pmapDirtyAll = true;
 	int movingType, destinationType;
 	// can_move[moving type][type at destination]
 	//  0 = No move/Bounce
@@ -2544,6 +2657,50 @@ void Simulation::init_can_move()
 	can_move[PT_THDR][PT_THDR] = 2;
 	can_move[PT_EMBR][PT_EMBR] = 2;
 	can_move[PT_TRON][PT_SWCH] = 3;
+
+	// wall_kill and settleable depend on element properties too, everything that changes those calls this
+	init_wall_kill();
+	init_settleable();
+}
+
+void Simulation::init_wall_kill()
+{
+	// wall_kill[type][wall]
+	//  0 = Particle survives
+	//  1 = Particle is killed
+	//  2 = Particle is killed if the wall isn't powered (emap is 0)
+	for (int t = 0; t < PT_NUM; t++)
+	{
+		auto properties = elements[t].Properties;
+		for (int wall = 0; wall < UI_WALLCOUNT; wall++)
+			wall_kill[t][wall] = 0;
+		// stickmen and fighters handle walls themselves
+		if (t == PT_STKM || t == PT_STKM2 || t == PT_FIGH)
+			continue;
+		wall_kill[t][WL_WALL] = 1;
+		wall_kill[t][WL_WALLELEC] = 1;
+		wall_kill[t][WL_ALLOWAIR] = 1;
+		wall_kill[t][WL_DESTROYALL] = 1;
+		wall_kill[t][WL_ALLOWLIQUID] = !(properties&TYPE_LIQUID);
+		wall_kill[t][WL_ALLOWPOWDER] = !(properties&TYPE_PART);
+		wall_kill[t][WL_ALLOWGAS] = !(properties&TYPE_GAS);
+		wall_kill[t][WL_ALLOWENERGY] = !(properties&TYPE_ENERGY);
+		wall_kill[t][WL_EWALL] = 2;
+	}
+}
+
+void Simulation::init_settleable()
+{
+	// Solids that only ever change through heat conduction when left alone: no update
+	// function, no pressure transitions, no explosions, and none of the special cases
+	// UpdateParticles has for some types around the heat transfer code
+	for (int t = 0; t < PT_NUM; t++)
+	{
+		auto &elem = elements[t];
+		settleable[t] = t && elem.Enabled && (elem.Properties&TYPE_SOLID) && !elem.Update && !(elem.Explosive&2)
+		             && elem.HighPressureTransition < 0 && elem.LowPressureTransition < 0
+		             && t != PT_LIFE && t != PT_ICEI && t != PT_SNOW && t != PT_HSWC && t != PT_SPRK && t != PT_GEL;
+	}
 }
 
 /*
@@ -2638,6 +2795,8 @@ int Simulation::eval_move(int pt, int nx, int ny, unsigned *rr)
 int Simulation::try_move(int i, int x, int y, int nx, int ny)
 {
 	unsigned r = 0, e;
+	if (profiler.enabled)
+		profiler.Count(SimulationProfiler::TryMove);
 
 	if (x==nx && y==ny)
 		return 1;
@@ -2647,7 +2806,7 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 	e = eval_move(parts[i].type, nx, ny, &r);
 
 	/* half-silvered mirror */
-	if (!e && parts[i].type==PT_PHOT && ((TYP(r)==PT_BMTL && RNG::Ref().chance(1, 2)) || TYP(pmap[y][x])==PT_BMTL))
+	if (!e && parts[i].type==PT_PHOT && ((TYP(r)==PT_BMTL && rng.chance(1, 2)) || TYP(pmap[y][x])==PT_BMTL))
 		e = 2;
 
 	if (!e) //if no movement
@@ -2691,6 +2850,8 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 				{
 					portalp[parts[ID(r)].tmp][count][nnx] = parts[i];
 					parts[i].type=PT_NONE;
+					partsType[i] = PT_NONE;
+					UpdateSubframeOrder(i);
 					break;
 				}
 		}
@@ -2699,7 +2860,7 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 
 	debug_interestingChangeOccurred = true;
 
-	int Element_FILT_interactWavelengths(Particle* cpart, int origWl);
+	int Element_FILT_interactWavelengths(Simulation *sim, Particle* cpart, int origWl);
 	if (e == 2) //if occupy same space
 	{
 		switch (parts[i].type)
@@ -2709,14 +2870,14 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 			switch (TYP(r))
 			{
 			case PT_GLOW:
-				if (!parts[ID(r)].life && RNG::Ref().chance(29, 30))
+				if (!parts[ID(r)].life && rng.chance(29, 30))
 				{
 					parts[ID(r)].life = 120;
 					create_gain_photon(i);
 				}
 				break;
 			case PT_FILT:
-				parts[i].ctype = Element_FILT_interactWavelengths(&parts[ID(r)], parts[i].ctype);
+				parts[i].ctype = Element_FILT_interactWavelengths(this, &parts[ID(r)], parts[i].ctype);
 				break;
 			case PT_C5:
 				if (parts[ID(r)].life > 0 && (parts[ID(r)].ctype & parts[i].ctype & 0xFFFFFFC0))
@@ -2798,7 +2959,7 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 		}
 		case PT_NEUT:
 			if (TYP(r) == PT_GLAS || TYP(r) == PT_BGLA)
-				if (RNG::Ref().chance(9, 10))
+				if (rng.chance(9, 10))
 					create_cherenkov_photon(i);
 			break;
 		case PT_ELEC:
@@ -2815,7 +2976,7 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 		case PT_BIZR:
 		case PT_BIZRG:
 			if (TYP(r) == PT_FILT)
-				parts[i].ctype = Element_FILT_interactWavelengths(&parts[ID(r)], parts[i].ctype);
+				parts[i].ctype = Element_FILT_interactWavelengths(this, &parts[ID(r)], parts[i].ctype);
 			break;
 		}
 		return 1;
@@ -2917,6 +3078,11 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 			parts[ri].x = float(x);
 			parts[ri].y = float(y);
 			pmap[y][x] = PMAP(ri, parts[ri].type);
+			MarkPmapDirty(nx, ny);
+			MarkPmapDirty(x, y);
+			if (s)
+				UpdateSubframeOrder(ID(s));
+			UpdateSubframeOrder(ri);
 			return 1;
 		}
 
@@ -2925,6 +3091,9 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 		parts[ri].x += float(x-nx);
 		parts[ri].y += float(y-ny);
 		pmap[(int)(parts[ri].y+0.5f)][(int)(parts[ri].x+0.5f)] = PMAP(ri, parts[ri].type);
+		MarkPmapDirty(nx, ny);
+		MarkPmapDirty((int)(parts[ri].x+0.5f), (int)(parts[ri].y+0.5f));
+		UpdateSubframeOrder(ri);
 	}
 	return 1;
 }
@@ -2966,6 +3135,7 @@ int Simulation::do_move(int i, int x, int y, float nxf, float nyf)
 				pmap[y][x] = 0;
 			if (ID(photons[y][x]) == i)
 				photons[y][x] = 0;
+			MarkPmapDirty(x, y);
 			// kill_part if particle is out of bounds
 			if (nx < CELL || nx >= XRES - CELL || ny < CELL || ny >= YRES - CELL)
 			{
@@ -2976,6 +3146,8 @@ int Simulation::do_move(int i, int x, int y, float nxf, float nyf)
 				photons[ny][nx] = PMAP(i, t);
 			else if (t)
 				pmap[ny][nx] = PMAP(i, t);
+			MarkPmapDirty(nx, ny);
+			UpdateSubframeOrder(i);
 		}
 	}
 	return result;
@@ -3151,6 +3323,8 @@ void Simulation::kill_part(int i)//kills particle number i
 {
 	if (i < 0 || i >= NPART)
 		return;
+	if (profiler.enabled)
+		profiler.Count(SimulationProfiler::KillPart);
 
 	debug_interestingChangeOccurred = true;
 	
@@ -3169,6 +3343,7 @@ void Simulation::kill_part(int i)//kills particle number i
 			pmap[y][x] = 0;
 		else if (ID(photons[y][x]) == i)
 			photons[y][x] = 0;
+		MarkPmapDirty(x, y);
 	}
 
 	// This shouldn't happen but ... you never know?
@@ -3178,8 +3353,10 @@ void Simulation::kill_part(int i)//kills particle number i
 	elementCount[t]--;
 
 	parts[i].type = PT_NONE;
+	partsType[i] = PT_NONE;
 	parts[i].life = pfree;
 	pfree = i;
+	UpdateSubframeOrder(i);
 }
 
 // Changes the type of particle number i, to t.  This also changes pmap at the same time
@@ -3187,6 +3364,8 @@ void Simulation::kill_part(int i)//kills particle number i
 bool Simulation::part_change_type(int i, int x, int y, int t)
 {
 	debug_interestingChangeOccurred = true;
+	if (profiler.enabled)
+		profiler.Count(SimulationProfiler::PartChangeType);
 
 	if (x<0 || y<0 || x>=XRES || y>=YRES || i>=NPART || t<0 || t>=PT_NUM || !parts[i].type)
 		return false;
@@ -3211,6 +3390,7 @@ bool Simulation::part_change_type(int i, int x, int y, int t)
 	elementCount[t]++;
 
 	parts[i].type = t;
+	partsType[i] = t;
 	if (elements[t].Properties & TYPE_ENERGY)
 	{
 		photons[y][x] = PMAP(i, t);
@@ -3223,6 +3403,7 @@ bool Simulation::part_change_type(int i, int x, int y, int t)
 		if (ID(photons[y][x]) == i)
 			photons[y][x] = 0;
 	}
+	MarkPmapDirty(x, y);
 	return false;
 }
 
@@ -3232,6 +3413,8 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 {
 	int i, oldType = PT_NONE;
 	debug_interestingChangeOccurred = true;
+	if (profiler.enabled)
+		profiler.Count(SimulationProfiler::CreatePart);
 
 	if (x<0 || y<0 || x>=XRES || y>=YRES || t<=0 || t>=PT_NUM || !elements[t].Enabled)
 		return -1;
@@ -3253,9 +3436,11 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 			return index;
 		}
 		parts[index].type = PT_SPRK;
+		partsType[index] = PT_SPRK;
 		parts[index].life = 4;
 		parts[index].ctype = type;
 		pmap[y][x] = (pmap[y][x]&~PMAPMASK) | PT_SPRK;
+		MarkPmapDirty(x, y);
 		if (parts[index].temp+10.0f < 673.0f && !legacy_enable && (type==PT_METL || type == PT_BMTL || type == PT_BRMT || type == PT_PSCN || type == PT_NSCN || type == PT_ETRD || type == PT_NBLE || type == PT_IRON))
 			parts[index].temp = parts[index].temp+10.0f;
 		return index;
@@ -3321,6 +3506,8 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 			pmap[oldY][oldX] = 0;
 		if (ID(photons[oldY][oldX]) == p)
 			photons[oldY][oldX] = 0;
+		if (oldX >= 0 && oldY >= 0 && oldX < XRES && oldY < YRES)
+			MarkPmapDirty(oldX, oldY);
 
 		oldType = parts[p].type;
 
@@ -3336,8 +3523,10 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 
 	parts[i] = elements[t].DefaultProperties;
 	parts[i].type = t;
+	partsType[i] = t;
 	parts[i].x = (float)x;
 	parts[i].y = (float)y;
+	UpdateSubframeOrder(i);
 
 	if (t == PT_CRAY && (p == -2))
 	{
@@ -3349,18 +3538,19 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 		photons[y][x] = PMAP(i, t);
 	else if (t!=PT_STKM && t!=PT_STKM2 && t!=PT_FIGH)
 		pmap[y][x] = PMAP(i, t);
+	MarkPmapDirty(x, y);
 
 	//Fancy dust effects for powder types
 	if((elements[t].Properties & TYPE_PART) && pretty_powder)
 	{
 		int colr, colg, colb;
-		colr = PIXR(elements[t].Colour) + int(sandcolour * 1.3) + RNG::Ref().between(-20, 20) + RNG::Ref().between(-15, 15);
-		colg = PIXG(elements[t].Colour) + int(sandcolour * 1.3) + RNG::Ref().between(-20, 20) + RNG::Ref().between(-15, 15);
-		colb = PIXB(elements[t].Colour) + int(sandcolour * 1.3) + RNG::Ref().between(-20, 20) + RNG::Ref().between(-15, 15);
+		colr = PIXR(elements[t].Colour) + int(sandcolour * 1.3) + rng.between(-20, 20) + rng.between(-15, 15);
+		colg = PIXG(elements[t].Colour) + int(sandcolour * 1.3) + rng.between(-20, 20) + rng.between(-15, 15);
+		colb = PIXB(elements[t].Colour) + int(sandcolour * 1.3) + rng.between(-20, 20) + rng.between(-15, 15);
 		colr = colr>255 ? 255 : (colr<0 ? 0 : colr);
 		colg = colg>255 ? 255 : (colg<0 ? 0 : colg);
 		colb = colb>255 ? 255 : (colb<0 ? 0 : colb);
-		parts[i].dcolour = (RNG::Ref().between(0, 149)<<24) | (colr<<16) | (colg<<8) | colb;
+		parts[i].dcolour = (rng.between(0, 149)<<24) | (colr<<16) | (colg<<8) | colb;
 	}
 
 	// Set non-static properties (such as randomly generated ones)
@@ -3405,7 +3595,7 @@ void Simulation::create_gain_photon(int pp)//photons from PHOT going through GLO
 		return;
 	i = pfree;
 
-	lr = RNG::Ref().between(0, 1);
+	lr = rng.between(0, 1);
 
 	if (lr) {
 		xx = parts[pp].x - 0.3*parts[pp].vy;
@@ -3428,9 +3618,11 @@ void Simulation::create_gain_photon(int pp)//photons from PHOT going through GLO
 	if (i>parts_lastActiveIndex) parts_lastActiveIndex = i;
 
 	parts[i].type = PT_PHOT;
+	partsType[i] = PT_PHOT;
 	parts[i].life = 680;
 	parts[i].x = xx;
 	parts[i].y = yy;
+	UpdateSubframeOrder(i);
 	parts[i].vx = parts[pp].vx;
 	parts[i].vy = parts[pp].vy;
 	parts[i].temp = parts[ID(pmap[ny][nx])].temp;
@@ -3438,6 +3630,7 @@ void Simulation::create_gain_photon(int pp)//photons from PHOT going through GLO
 	parts[i].tmp3 = 0;
 	parts[i].tmp4 = 0;
 	photons[ny][nx] = PMAP(i, PT_PHOT);
+	MarkPmapDirty(nx, ny);
 
 	temp_bin = (int)((parts[i].temp-273.0f)*0.25f);
 	if (temp_bin < 0) temp_bin = 0;
@@ -3465,18 +3658,21 @@ void Simulation::create_cherenkov_photon(int pp)//photons from NEUT going throug
 	pfree = parts[i].life;
 	if (i>parts_lastActiveIndex) parts_lastActiveIndex = i;
 
-	lr = RNG::Ref().between(0, 1);
+	lr = rng.between(0, 1);
 
 	parts[i].type = PT_PHOT;
+	partsType[i] = PT_PHOT;
 	parts[i].ctype = 0x00000F80;
 	parts[i].life = 680;
 	parts[i].x = parts[pp].x;
 	parts[i].y = parts[pp].y;
+	UpdateSubframeOrder(i);
 	parts[i].temp = parts[ID(pmap[ny][nx])].temp;
 	parts[i].tmp = 0;
 	parts[i].tmp3 = 0;
 	parts[i].tmp4 = 0;
 	photons[ny][nx] = PMAP(i, PT_PHOT);
+	MarkPmapDirty(nx, ny);
 
 	if (lr) {
 		parts[i].vx = parts[pp].vx - 2.5f*parts[pp].vy;
@@ -3509,25 +3705,97 @@ void Simulation::delete_part(int x, int y)//calls kill_part with the particle lo
 	kill_part(ID(i));
 }
 
+uint64_t Simulation::StateHash() const
+{
+	constexpr size_t cells = (XRES / CELL) * (YRES / CELL);
+	uint64_t hash = UINT64_C(0xCBF29CE484222325);
+	hash = HashBytes(hash, &parts[0], sizeof(Particle) * (parts_lastActiveIndex + 1));
+	hash = HashBytes(hash, pmap, sizeof(pmap));
+	hash = HashBytes(hash, photons, sizeof(photons));
+	hash = HashBytes(hash, pv, sizeof(float) * cells);
+	hash = HashBytes(hash, vx, sizeof(float) * cells);
+	hash = HashBytes(hash, vy, sizeof(float) * cells);
+	hash = HashBytes(hash, hv, sizeof(float) * cells);
+	hash = HashBytes(hash, gravx, sizeof(float) * cells);
+	hash = HashBytes(hash, gravy, sizeof(float) * cells);
+	hash = HashBytes(hash, gravp, sizeof(float) * cells);
+	hash = HashBytes(hash, gravmap, sizeof(float) * cells);
+	hash = HashBytes(hash, bmap, sizeof(bmap));
+	hash = HashBytes(hash, emap, sizeof(emap));
+	auto rngState = rng.state();
+	hash = HashBytes(hash, rngState.data(), sizeof(rngState));
+	return hash;
+}
+
 bool Simulation::AreParticlesInSubframeOrder()
 {
-	int cx = 0, cy = 0;
-	for (int i = 0; i < NPART; i++)
+	return !GetSubframeOrderBreaks();
+}
+
+int Simulation::GetSubframeOrderBreaks()
+{
+	if (subframeOrderStale)
+		RecountSubframeOrder();
+	return subframeOrderBreaks;
+}
+
+// Call after particle i was created, killed or moved
+void Simulation::UpdateSubframeOrder(int i)
+{
+	if (subframeOrderStale)
+		return;
+	int64_t oldKey = subframeOrderKey[i];
+	int64_t newKey = parts[i].type ? SubframeOrderKey(parts[i]) : noSubframeOrderKey;
+	if (oldKey == newKey)
+		return;
+
+	int prev = i - 1, next = i + 1;
+	int searchEnd = std::min(parts_lastActiveIndex + 1, i + 1 + subframeOrderSearchLimit);
+	while (prev >= 0 && subframeOrderKey[prev] == noSubframeOrderKey && i - prev <= subframeOrderSearchLimit)
+		prev--;
+	while (next < searchEnd && subframeOrderKey[next] == noSubframeOrderKey)
+		next++;
+	if ((prev >= 0 && subframeOrderKey[prev] == noSubframeOrderKey) || (next == searchEnd && searchEnd <= parts_lastActiveIndex))
+	{
+		subframeOrderStale = true;
+		return;
+	}
+	int64_t prevKey = prev >= 0 ? subframeOrderKey[prev] : noSubframeOrderKey;
+	int64_t nextKey = next < searchEnd ? subframeOrderKey[next] : noSubframeOrderKey;
+
+	// number of breaks between neighbouring particles a and b, either of which may be missing
+	auto breaks = [](int64_t a, int64_t b) {
+		return (a != noSubframeOrderKey && b != noSubframeOrderKey && b < a) ? 1 : 0;
+	};
+	if (oldKey == noSubframeOrderKey)
+		subframeOrderBreaks -= breaks(prevKey, nextKey);
+	else
+		subframeOrderBreaks -= breaks(prevKey, oldKey) + breaks(oldKey, nextKey);
+	if (newKey == noSubframeOrderKey)
+		subframeOrderBreaks += breaks(prevKey, nextKey);
+	else
+		subframeOrderBreaks += breaks(prevKey, newKey) + breaks(newKey, nextKey);
+	subframeOrderKey[i] = newKey;
+}
+
+void Simulation::RecountSubframeOrder()
+{
+	int64_t prevKey = noSubframeOrderKey;
+	subframeOrderBreaks = 0;
+	for (int i = 0; i <= parts_lastActiveIndex; i++)
 	{
-		int x, y;
-		x = int(parts[i].x + 0.5f);
-		y = int(parts[i].y + 0.5f);
 		if (!parts[i].type)
 		{
+			subframeOrderKey[i] = noSubframeOrderKey;
 			continue;
 		}
-		if (y < cy || (y == cy && x < cx)) {
-			return false;
-		}
-		cx = x;
-		cy = y;
+		int64_t key = SubframeOrderKey(parts[i]);
+		subframeOrderKey[i] = key;
+		if (prevKey != noSubframeOrderKey && key < prevKey)
+			subframeOrderBreaks++;
+		prevKey = key;
 	}
-	return true;
+	subframeOrderStale = false;
 }
 
 void Simulation::CompleteDebugUpdateParticles()
@@ -3540,6 +3808,111 @@ void Simulation::CompleteDebugUpdateParticles()
 	}
 }
 
+void Simulation::AddBreakpoint(ParticleBreakpoint breakpoint)
+{
+	if (breakpoint.kind == ParticleBreakpoint::Property || breakpoint.kind == ParticleBreakpoint::PropertyAt)
+	{
+		breakpoint.lastValue = 0;
+		int id = WatchedParticle(breakpoint);
+		if (id >= 0)
+		{
+			std::memcpy(&breakpoint.lastValue, reinterpret_cast<char *>(&parts[id]) + breakpoint.offset, sizeof(breakpoint.lastValue));
+		}
+	}
+	debug_breakpoints.push_back(breakpoint);
+}
+
+int Simulation::WatchedParticle(const ParticleBreakpoint &breakpoint)
+{
+	if (breakpoint.kind == ParticleBreakpoint::Property)
+	{
+		return breakpoint.value;
+	}
+	int r = pmap[breakpoint.y][breakpoint.x];
+	if (!r)
+	{
+		r = photons[breakpoint.y][breakpoint.x];
+	}
+	return r ? ID(r) : -1;
+}
+
+// Returns true if the loop should stop right before updating particle i. i is NPART
+// at the end of the frame, which only brings watchpoints up to date. writer is the
+// particle updated last, which is blamed for watched properties that changed, or -1
+// if no particle has been updated since the last check.
+bool Simulation::CheckBreakpoints(int i, int writer, int writerType)
+{
+	bool hit = false;
+	for (auto &breakpoint : debug_breakpoints)
+	{
+		switch (breakpoint.kind)
+		{
+		case ParticleBreakpoint::Id:
+			hit = hit || i == breakpoint.value;
+			break;
+
+		case ParticleBreakpoint::Type:
+			hit = hit || (i < NPART && parts[i].type == breakpoint.value);
+			break;
+
+		case ParticleBreakpoint::Position:
+			hit = hit || (i < NPART && int(parts[i].x + 0.5f) == breakpoint.x && int(parts[i].y + 0.5f) == breakpoint.y);
+			break;
+
+		case ParticleBreakpoint::Property:
+		case ParticleBreakpoint::PropertyAt:
+			{
+				uint32_t value = 0;
+				int id = WatchedParticle(breakpoint);
+				if (id >= 0)
+				{
+					std::memcpy(&value, reinterpret_cast<char *>(&parts[id]) + breakpoint.offset, sizeof(value));
+				}
+				if (value != breakpoint.lastValue)
+				{
+					if (writer >= 0)
+					{
+						debug_breakpointHits.push_back({ id, breakpoint.offset, breakpoint.lastValue, value, writer, writerType });
+						hit = true;
+					}
+					breakpoint.lastValue = value;
+				}
+			}
+			break;
+
+		case ParticleBreakpoint::InterestingChange:
+			hit = hit || debug_interestingChangeOccurred;
+			break;
+		}
+	}
+	return hit;
+}
+
+// Runs the particle loop from debug_currentParticle until a breakpoint is hit or the
+// frame ends, in a single call to UpdateParticles. Returns the id of the particle the
+// loop stopped before, which is where it will resume, or NPART if the frame was finished.
+int Simulation::StepParticles()
+{
+	if (debug_currentParticle == 0)
+	{
+		framerender = 1;
+		BeforeSim();
+		framerender = 0;
+	}
+	debug_stepping = true;
+	debug_breakpointHit = NPART;
+	UpdateParticles(debug_currentParticle, NPART - 1);
+	debug_stepping = false;
+	if (debug_breakpointHit < NPART)
+	{
+		debug_currentParticle = debug_breakpointHit;
+		return debug_breakpointHit;
+	}
+	AfterSim();
+	debug_currentParticle = 0;
+	return NPART;
+}
+
 void Simulation::UpdateParticles(int start, int end)
 {
 	int i, j, x, y, t, nx, ny, r, surround_space, s, rt, nt;
@@ -3556,28 +3929,43 @@ void Simulation::UpdateParticles(int start, int end)
 	bool transitionOccurred;
 
 	debug_interestingChangeOccurred = false;
+	bool checkBreakpoints = debug_stepping || !debug_breakpoints.empty();
+	int lastUpdated = -1, lastUpdatedType = 0;
+	bool profile = profiler.enabled;
+	bool skipSettled = skipSettledParticles && !legacy_enable;
+	if (profile)
+		profiler.Begin(SimulationProfiler::Walls);
 
 	//the main particle loop function, goes over all particles.
 	for (i = start; i <= end && i <= parts_lastActiveIndex; i++)
 		if (parts[i].type)
 		{
+			if (checkBreakpoints)
+			{
+				if (CheckBreakpoints(i, lastUpdated, lastUpdatedType) && debug_stepping && i != start)
+				{
+					debug_breakpointHit = i;
+					break;
+				}
+				lastUpdated = i;
+				lastUpdatedType = parts[i].type;
+			}
+
 			t = parts[i].type;
+			if (profile)
+				profiler.Mark(SimulationProfiler::Walls, t);
 
 			x = (int)(parts[i].x+0.5f);
 			y = (int)(parts[i].y+0.5f);
 
 			//this kills any particle out of the screen, or in a wall where it isn't supposed to go
-			if (x<CELL || y<CELL || x>=XRES-CELL || y>=YRES-CELL ||
-			        (bmap[y/CELL][x/CELL] &&
-			         (bmap[y/CELL][x/CELL]==WL_WALL ||
-			          bmap[y/CELL][x/CELL]==WL_WALLELEC ||
-			          bmap[y/CELL][x/CELL]==WL_ALLOWAIR ||
-			          (bmap[y/CELL][x/CELL]==WL_DESTROYALL) ||
-			          (bmap[y/CELL][x/CELL]==WL_ALLOWLIQUID && !(elements[t].Properties&TYPE_LIQUID)) ||
-			          (bmap[y/CELL][x/CELL]==WL_ALLOWPOWDER && !(elements[t].Properties&TYPE_PART)) ||
-			          (bmap[y/CELL][x/CELL]==WL_ALLOWGAS && !(elements[t].Properties&TYPE_GAS)) || //&& elements[t].Falldown!=0 && parts[i].type!=PT_FIRE && parts[i].type!=PT_SMKE && parts[i].type!=PT_CFLM) ||
-					  (bmap[y/CELL][x/CELL]==WL_ALLOWENERGY && !(elements[t].Properties&TYPE_ENERGY)) ||
-			          (bmap[y/CELL][x/CELL]==WL_EWALL && !emap[y/CELL][x/CELL])) && (t!=PT_STKM) && (t!=PT_STKM2) && (t!=PT_FIGH)))
+			if (x<CELL || y<CELL || x>=XRES-CELL || y>=YRES-CELL)
+			{
+				kill_part(i);
+				continue;
+			}
+			int wall = bmap[y/CELL][x/CELL];
+			if (wall < UI_WALLCOUNT && wall_kill[t][wall] && (wall_kill[t][wall] == 1 || !emap[y/CELL][x/CELL]))
 			{
 				kill_part(i);
 				continue;
@@ -3591,6 +3979,8 @@ void Simulation::UpdateParticles(int start, int end)
 			if (bmap[y/CELL][x/CELL]==WL_DETECT && emap[y/CELL][x/CELL]<8)
 				set_emap(x/CELL, y/CELL);
 
+			if (profile)
+				profiler.Mark(SimulationProfiler::Air);
 			//adding to velocity from the particle's velocity
 			vx[y/CELL][x/CELL] = vx[y/CELL][x/CELL]*elements[t].AirLoss + elements[t].AirDrag*parts[i].vx;
 			vy[y/CELL][x/CELL] = vy[y/CELL][x/CELL]*elements[t].AirLoss + elements[t].AirDrag*parts[i].vy;
@@ -3625,6 +4015,8 @@ void Simulation::UpdateParticles(int start, int end)
 				}
 			}
 
+			if (profile)
+				profiler.Mark(SimulationProfiler::Velocity);
 			pGravX = pGravY = 0;
 			if (!(elements[t].Properties & TYPE_SOLID))
 			{
@@ -3671,14 +4063,34 @@ void Simulation::UpdateParticles(int start, int end)
 			{
 #ifdef REALISTIC
 				//The magic number controls diffusion speed
-				parts[i].vx += 0.05*sqrtf(parts[i].temp)*elements[t].Diffusion*(2.0f*RNG::Ref().uniform01()-1.0f);
-				parts[i].vy += 0.05*sqrtf(parts[i].temp)*elements[t].Diffusion*(2.0f*RNG::Ref().uniform01()-1.0f);
+				parts[i].vx += 0.05*sqrtf(parts[i].temp)*elements[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
+				parts[i].vy += 0.05*sqrtf(parts[i].temp)*elements[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
 #else
-				parts[i].vx += elements[t].Diffusion*(2.0f*RNG::Ref().uniform01()-1.0f);
-				parts[i].vy += elements[t].Diffusion*(2.0f*RNG::Ref().uniform01()-1.0f);
+				parts[i].vx += elements[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
+				parts[i].vy += elements[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
 #endif
 			}
 
+			if (profile)
+				profiler.Mark(SimulationProfiler::Heat);
+#ifndef REALISTIC
+			// Settled particles don't need the rest of their update, but the random number the
+			// heat transfer code draws still has to be drawn. If it says heat is conducted and
+			// that would change some temperature, the normal update goes on with that draw.
+			bool heatDrawn = false;
+			if (skipSettled && IsSettled(i, t, x, y))
+			{
+				if (!rng.chance(elements[t].HeatConduct, 250))
+				{
+					if (!(air->bmap_blockairh[y/CELL][x/CELL]&0x8))
+						air->bmap_blockairh[y/CELL][x/CELL]++;
+					continue;
+				}
+				if (IsHeatSettled(i, x, y))
+					continue;
+				heatDrawn = true;
+			}
+#endif
 			transitionOccurred = false;
 
 			j = surround_space = nt = 0;//if nt is greater than 1 after this, then there is a particle around the current particle, that is NOT the current particle's type, for water movement.
@@ -3700,7 +4112,7 @@ void Simulation::UpdateParticles(int start, int end)
 
 			if (!legacy_enable)
 			{
-				if (y-2 >= 0 && y-2 < YRES && (elements[t].Properties&TYPE_LIQUID) && (t!=PT_GEL || gel_scale > (1 + RNG::Ref().between(0, 254)))) {//some heat convection for liquids
+				if (y-2 >= 0 && y-2 < YRES && (elements[t].Properties&TYPE_LIQUID) && (t!=PT_GEL || gel_scale > (1 + rng.between(0, 254)))) {//some heat convection for liquids
 					r = pmap[y-2][x];
 					if (!(!r || parts[i].type != TYP(r))) {
 						if (parts[i].temp>parts[ID(r)].temp) {
@@ -3716,7 +4128,7 @@ void Simulation::UpdateParticles(int start, int end)
 #ifdef REALISTIC
 				if (t&&(t!=PT_HSWC||parts[i].life==10)&&(elements[t].HeatConduct*gel_scale))
 #else
-				if (t && (t!=PT_HSWC||parts[i].life==10) && RNG::Ref().chance(int(elements[t].HeatConduct*gel_scale), 250))
+				if (t && (t!=PT_HSWC||parts[i].life==10) && (heatDrawn || rng.chance(int(elements[t].HeatConduct*gel_scale), 250)))
 #endif
 				{
 					if (aheat_enable && !(elements[t].Properties&PROP_NOAMBHEAT))
@@ -3792,6 +4204,8 @@ void Simulation::UpdateParticles(int start, int end)
 					}
 #endif
 
+					if (profile)
+						profiler.Mark(SimulationProfiler::Transitions);
 					ctemph = ctempl = pt;
 					// change boiling point with pressure
 					if (((elements[t].Properties&TYPE_LIQUID) && IsElementOrNone(elements[t].HighTemperatureTransition) && (elements[elements[t].HighTemperatureTransition].Properties&TYPE_GAS))
@@ -3873,7 +4287,7 @@ void Simulation::UpdateParticles(int start, int end)
 							{
 								pt = (c_heat - platent[t])/c_Cm;
 
-								if (RNG::Ref().chance(1, 4))
+								if (rng.chance(1, 4))
 									t = PT_SALT;
 								else
 									t = PT_WTRV;
@@ -3884,7 +4298,7 @@ void Simulation::UpdateParticles(int start, int end)
 								s = 0;
 							}
 #else
-							if (RNG::Ref().chance(1, 4))
+							if (rng.chance(1, 4))
 								t = PT_SALT;
 							else
 								t = PT_WTRV;
@@ -3900,6 +4314,7 @@ void Simulation::UpdateParticles(int start, int end)
 								{
 									t = PT_LAVA;
 									parts[i].type = PT_TUNG;
+									partsType[i] = PT_TUNG;
 								}
 							}
 							else if (ctemph >= elements[t].HighTemperature)
@@ -4036,7 +4451,7 @@ void Simulation::UpdateParticles(int start, int end)
 							goto killed;
 
 						if (t==PT_FIRE || t==PT_PLSM || t==PT_CFLM)
-							parts[i].life = RNG::Ref().between(120, 169);
+							parts[i].life = rng.between(120, 169);
 						if (t == PT_LAVA)
 						{
 							if (parts[i].ctype == PT_BRMT) parts[i].ctype = PT_BMTL;
@@ -4044,7 +4459,7 @@ void Simulation::UpdateParticles(int start, int end)
 							else if (parts[i].ctype == PT_BGLA) parts[i].ctype = PT_GLAS;
 							else if (parts[i].ctype == PT_PQRT) parts[i].ctype = PT_QRTZ;
 							else if (parts[i].ctype == PT_LITH && parts[i].tmp2 > 3) parts[i].ctype = PT_GLAS;
-							parts[i].life = RNG::Ref().between(240, 359);
+							parts[i].life = rng.between(240, 359);
 						}
 						transitionOccurred = true;
 					}
@@ -4073,6 +4488,8 @@ void Simulation::UpdateParticles(int start, int end)
 				}
 			}
 
+			if (profile)
+				profiler.Mark(SimulationProfiler::Transitions);
 			if (t==PT_LIFE)
 			{
 				parts[i].temp = restrict_flt(parts[i].temp-50.0f, MIN_TEMP, MAX_TEMP);
@@ -4118,7 +4535,7 @@ void Simulation::UpdateParticles(int start, int end)
 			//the basic explosion, from the .explosive variable
 			if ((elements[t].Explosive&2) && pv[y/CELL][x/CELL]>2.5f)
 			{
-				parts[i].life = RNG::Ref().between(180, 259);
+				parts[i].life = rng.between(180, 259);
 				parts[i].temp = restrict_flt(elements[PT_FIRE].DefaultProperties.temp + (elements[t].Flammable/2), MIN_TEMP, MAX_TEMP);
 				t = PT_FIRE;
 				part_change_type(i,x,y,t);
@@ -4174,10 +4591,12 @@ void Simulation::UpdateParticles(int start, int end)
 				if (part_change_type(i,x,y,t))
 					goto killed;
 				if (t == PT_FIRE)
-					parts[i].life = RNG::Ref().between(120, 169);
+					parts[i].life = rng.between(120, 169);
 				transitionOccurred = true;
 			}
 
+			if (profile)
+				profiler.Mark(SimulationProfiler::Update);
 			//call the particle update function, if there is one
 #if !defined(RENDERER) && defined(LUACONSOLE)
 			if (lua_el_mode[parts[i].type] == 3)
@@ -4218,6 +4637,8 @@ void Simulation::UpdateParticles(int start, int end)
 				Element::legacyUpdate(this, i,x,y,surround_space,nt, parts, pmap);
 
 killed:
+			if (profile)
+				profiler.Mark(SimulationProfiler::Movement);
 			if (parts[i].type == PT_NONE)//if its dead, skip to next particle
 				continue;
 
@@ -4367,6 +4788,7 @@ killed:
 						pmap[y][x] = 0;
 					else if (ID(photons[y][x]) == i)
 						photons[y][x] = 0;
+					MarkPmapDirty(x, y);
 					if (nx<CELL || nx>=XRES-CELL || ny<CELL || ny>=YRES-CELL)
 					{
 						kill_part(i);
@@ -4376,6 +4798,8 @@ killed:
 						photons[ny][nx] = PMAP(i, t);
 					else if (t)
 						pmap[ny][nx] = PMAP(i, t);
+					MarkPmapDirty(nx, ny);
+					UpdateSubframeOrder(i);
 				}
 			}
 			else if (elements[t].Properties & TYPE_ENERGY)
@@ -4447,7 +4871,7 @@ killed:
 						continue;
 					// reflection
 					parts[i].flags |= FLAG_STAGNANT;
-					if (t==PT_NEUT && RNG::Ref().chance(1, 10))
+					if (t==PT_NEUT && rng.chance(1, 10))
 					{
 						kill_part(i);
 						continue;
@@ -4472,7 +4896,7 @@ killed:
 					{
 						if (TYP(r) == PT_CRMC)
 						{
-							float r = RNG::Ref().between(-50, 50) * 0.01f, rx, ry, anrx, anry;
+							float r = rng.between(-50, 50) * 0.01f, rx, ry, anrx, anry;
 							r = r * r * r;
 							rx = cosf(r); ry = sinf(r);
 							anrx = rx * nrx + ry * nry;
@@ -4534,7 +4958,7 @@ killed:
 			else
 			{
 				// Checking stagnant is cool, but then it doesn't update when you change it later.
-				if (water_equal_test && elements[t].Falldown == 2 && RNG::Ref().chance(1, 200))
+				if (water_equal_test && elements[t].Falldown == 2 && rng.chance(1, 200))
 				{
 					if (flood_water(x, y, i))
 						goto movedone;
@@ -4557,7 +4981,7 @@ killed:
 					else
 					{
 						s = 1;
-						r = RNG::Ref().between(0, 1) * 2 - 1;// position search direction (left/right first)
+						r = rng.between(0, 1) * 2 - 1;// position search direction (left/right first)
 						if ((clear_x!=x || clear_y!=y || nt || surround_space) &&
 							(fabsf(parts[i].vx)>0.01f || fabsf(parts[i].vy)>0.01f))
 						{
@@ -4788,6 +5212,12 @@ killed:
 movedone:
 			continue;
 		}
+	if (profile)
+		profiler.End();
+	if (checkBreakpoints && (!debug_stepping || debug_breakpointHit == NPART))
+	{
+		CheckBreakpoints(NPART, lastUpdated, lastUpdatedType);
+	}
 
 	//'f' was pressed (single frame)
 	if (framerender)
@@ -4815,41 +5245,207 @@ int Simulation::GetParticleType(ByteString type)
 	return -1;
 }
 
+void Simulation::AddToPmap(int i, int t, int x, int y)
+{
+	if (elements[t].Properties & TYPE_ENERGY)
+		photons[y][x] = PMAP(i, t);
+	else
+	{
+		// Particles are sometimes allowed to go inside INVS and FILT
+		// To make particles collide correctly when inside these elements, these elements must not overwrite an existing pmap entry from particles inside them
+		if (!pmap[y][x] || (t!=PT_INVIS && t!= PT_FILT))
+			pmap[y][x] = PMAP(i, t);
+		// (there are a few exceptions, including energy particles - currently no limit on stacking those)
+		if (t!=PT_THDR && t!=PT_EMBR && t!=PT_FIGH && t!=PT_PLSM)
+			pmap_count[y][x]++;
+	}
+}
+
+// Rebuilds pmap, photons and pmap_count in the dirty cells (or everywhere) from pmapRecord,
+// replaying the particles in killed (sorted by id) being killed right after they were added,
+// the same as RecalcFreeParticles would have done if it had rebuilt the cell itself
+void Simulation::RebuildPmap(bool all, const std::vector<int> &killed, int lastIndex)
+{
+	if (all)
+	{
+		memset(pmap, 0, sizeof(pmap));
+		memset(pmap_count, 0, sizeof(pmap_count));
+		memset(photons, 0, sizeof(photons));
+	}
+	else
+	{
+		for (auto cell : pmapDirtyCells)
+		{
+			int x = cell % XRES, y = cell / XRES;
+			pmap[y][x] = 0;
+			pmap_count[y][x] = 0;
+			photons[y][x] = 0;
+		}
+	}
+	auto nextKilled = killed.begin();
+	for (int i = 0; i <= lastIndex; i++)
+	{
+		int record = pmapRecord[i];
+		if (record < 0)
+			continue;
+		int x = ID(record) % XRES;
+		int y = ID(record) / XRES;
+		if (!all && !pmapDirty[y][x])
+			continue;
+		AddToPmap(i, TYP(record), x, y);
+		while (nextKilled != killed.end() && *nextKilled < i)
+			++nextKilled;
+		if (nextKilled != killed.end() && *nextKilled == i)
+		{
+			if (ID(pmap[y][x]) == i)
+				pmap[y][x] = 0;
+			else if (ID(photons[y][x]) == i)
+				photons[y][x] = 0;
+		}
+	}
+}
+
+// decreases particle life, returns true if the particle was killed
+bool Simulation::DecreaseLife(int i, int t, int x, int y, bool inBounds)
+{
+	if (t<0 || t>=PT_NUM || !elements[t].Enabled)
+	{
+		kill_part(i);
+		return true;
+	}
+
+	unsigned int elem_properties = elements[t].Properties;
+	if (parts[i].life>0 && (elem_properties&PROP_LIFE_DEC) && !(inBounds && bmap[y/CELL][x/CELL] == WL_STASIS && emap[y/CELL][x/CELL]<8))
+	{
+		// automatically decrease life
+		parts[i].life--;
+		if (parts[i].life<=0 && (elem_properties&(PROP_LIFE_KILL_DEC|PROP_LIFE_KILL)))
+		{
+			// kill on change to no life
+			kill_part(i);
+			return true;
+		}
+	}
+	else if (parts[i].life<=0 && (elem_properties&PROP_LIFE_KILL) && !(inBounds && bmap[y/CELL][x/CELL] == WL_STASIS && emap[y/CELL][x/CELL]<8))
+	{
+		// kill if no life
+		kill_part(i);
+		return true;
+	}
+	return false;
+}
+
+// Whether the rest of the update of particle i, from the heat transfer code on, can't do
+// anything but conduct heat, and count the particle in bmap_blockairh if it doesn't.
+// Checked after velocities are updated; doesn't check the neighbours, see IsHeatSettled.
+bool Simulation::IsSettled(int i, int t, int x, int y)
+{
+	if (!settleable[t] || parts[i].vx || parts[i].vy)
+		return false;
+#if !defined(RENDERER) && defined(LUACONSOLE)
+	if (lua_el_mode[t])
+		return false;
+#endif
+	auto &elem = elements[t];
+	if (aheat_enable && !(elem.Properties&PROP_NOAMBHEAT))
+		return false;
+	float temp = parts[i].temp;
+	// out of range temperatures get clamped
+	if (!(temp >= MIN_TEMP && temp <= MAX_TEMP) || std::signbit(temp))
+		return false;
+	if ((elem.HighTemperatureTransition > -1 && temp >= elem.HighTemperature) || (elem.LowTemperatureTransition > -1 && temp < elem.LowTemperature))
+		return false;
+	if (elem.Properties&PROP_CONDUCTS)
+	{
+		// the spark from walls, see UpdateParticles
+		int nx = x % CELL == 0 ? x/CELL - 1 : (x % CELL == CELL-1 ? x/CELL + 1 : x/CELL);
+		int ny = y % CELL == 0 ? y/CELL - 1 : (y % CELL == CELL-1 ? y/CELL + 1 : y/CELL);
+		if (nx>=0 && ny>=0 && nx<XRES/CELL && ny<YRES/CELL && emap[ny][nx]==12 && !parts[i].life && bmap[ny][nx] != WL_STASIS)
+			return false;
+	}
+	return true;
+}
+
+static uint32_t FloatBits(float f)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+// Whether conducting heat between settled particle i and its neighbours leaves all of their
+// temperatures as they are. That's the case if the neighbours have exactly the temperature
+// of the particle, and averaging that many copies of it gives back the same float.
+bool Simulation::IsHeatSettled(int i, int x, int y)
+{
+	float temp = parts[i].temp;
+	auto bits = FloatBits(temp);
+	for (int ny = -1; ny <= 1; ny++)
+		for (int nx = -1; nx <= 1; nx++)
+		{
+			auto r = pmap[y+ny][x+nx];
+			if ((nx || ny) && r && FloatBits(parts[ID(r)].temp) != bits)
+				return false;
+		}
+	if (FloatBits(settledTemp) != bits)
+	{
+		settledTemp = temp;
+		settledTempFixed = true;
+		for (int count = 0; count <= 8; count++)
+		{
+			// The same sum and division as the heat transfer code; volatile keeps the
+			// compiler from folding the sum into a multiplication, which rounds differently
+			volatile float sum = 0.0f;
+			for (int k = 0; k < count; k++)
+				sum = sum + temp;
+			float pt = restrict_flt((sum+temp)/(count+1), MIN_TEMP, MAX_TEMP);
+			if (FloatBits(pt) != bits)
+				settledTempFixed = false;
+		}
+	}
+	return settledTempFixed;
+}
+
 void Simulation::RecalcFreeParticles(bool do_life_dec)
 {
 	int x, y, t;
 	int lastPartUsed = 0;
 	int lastPartUnused = -1;
+	int lastIndex = parts_lastActiveIndex;
+	std::vector<int> killed;
 
-	memset(pmap, 0, sizeof(pmap));
-	memset(pmap_count, 0, sizeof(pmap_count));
-	memset(photons, 0, sizeof(photons));
+	// Everything except the per frame update calls this after moving particles around in bulk,
+	// the per frame update only has to fix up the cells that something changed since last time
+	bool all = !do_life_dec || !incrementalPmap || pmapDirtyAll;
+
+	// recount subframe order as well, kill_part doesn't need to keep it up to date meanwhile
+	int64_t prevOrderKey = noSubframeOrderKey;
+	subframeOrderBreaks = 0;
+	subframeOrderStale = true;
 
 	NUM_PARTS = 0;
 	//the particle loop that resets the pmap/photon maps every frame, to update them.
 	for (int i = 0; i <= parts_lastActiveIndex; i++)
 	{
+		partsType[i] = parts[i].type;
 		if (parts[i].type)
 		{
 			t = parts[i].type;
 			x = (int)(parts[i].x+0.5f);
 			y = (int)(parts[i].y+0.5f);
-			bool inBounds = false;
-			if (x>=0 && y>=0 && x<XRES && y<YRES)
+			bool inBounds = x>=0 && y>=0 && x<XRES && y<YRES;
+			int record = inBounds ? PMAP(y*XRES+x, t) : -1;
+			if (pmapRecord[i] != record)
 			{
-				if (elements[t].Properties & TYPE_ENERGY)
-					photons[y][x] = PMAP(i, t);
-				else
+				// moved or changed type without going through anything that marks pmap dirty
+				if (!all)
 				{
-					// Particles are sometimes allowed to go inside INVS and FILT
-					// To make particles collide correctly when inside these elements, these elements must not overwrite an existing pmap entry from particles inside them
-					if (!pmap[y][x] || (t!=PT_INVIS && t!= PT_FILT))
-						pmap[y][x] = PMAP(i, t);
-					// (there are a few exceptions, including energy particles - currently no limit on stacking those)
-					if (t!=PT_THDR && t!=PT_EMBR && t!=PT_FIGH && t!=PT_PLSM)
-						pmap_count[y][x]++;
+					if (pmapRecord[i] >= 0)
+						MarkPmapDirty(ID(pmapRecord[i]) % XRES, ID(pmapRecord[i]) / XRES);
+					if (inBounds)
+						MarkPmapDirty(x, y);
 				}
-				inBounds = true;
+				pmapRecord[i] = record;
 			}
 			lastPartUsed = i;
 			NUM_PARTS ++;
@@ -4858,36 +5454,29 @@ void Simulation::RecalcFreeParticles(bool do_life_dec)
 				elementCount[t]++;
 
 			//decrease particle life
-			if (do_life_dec && (!sys_pause || framerender))
+			if (do_life_dec && (!sys_pause || framerender) && DecreaseLife(i, t, x, y, inBounds))
 			{
-				if (t<0 || t>=PT_NUM || !elements[t].Enabled)
-				{
-					kill_part(i);
-					continue;
-				}
-
-				unsigned int elem_properties = elements[t].Properties;
-				if (parts[i].life>0 && (elem_properties&PROP_LIFE_DEC) && !(inBounds && bmap[y/CELL][x/CELL] == WL_STASIS && emap[y/CELL][x/CELL]<8))
-				{
-					// automatically decrease life
-					parts[i].life--;
-					if (parts[i].life<=0 && (elem_properties&(PROP_LIFE_KILL_DEC|PROP_LIFE_KILL)))
-					{
-						// kill on change to no life
-						kill_part(i);
-						continue;
-					}
-				}
-				else if (parts[i].life<=0 && (elem_properties&PROP_LIFE_KILL) && !(inBounds && bmap[y/CELL][x/CELL] == WL_STASIS && emap[y/CELL][x/CELL]<8))
-				{
-					// kill if no life
-					kill_part(i);
-					continue;
-				}
+				if (inBounds)
+					killed.push_back(i);
+				subframeOrderKey[i] = noSubframeOrderKey;
+				continue;
 			}
+
+			int64_t orderKey = (int64_t(y) << 32) + x;
+			subframeOrderKey[i] = orderKey;
+			if (prevOrderKey != noSubframeOrderKey && orderKey < prevOrderKey)
+				subframeOrderBreaks++;
+			prevOrderKey = orderKey;
 		}
 		else
 		{
+			subframeOrderKey[i] = noSubframeOrderKey;
+			if (pmapRecord[i] >= 0)
+			{
+				if (!all)
+					MarkPmapDirty(ID(pmapRecord[i]) % XRES, ID(pmapRecord[i]) / XRES);
+				pmapRecord[i] = -1;
+			}
 			if (lastPartUnused<0) pfree = i;
 			else parts[lastPartUnused].life = i;
 			lastPartUnused = i;
@@ -4908,78 +5497,155 @@ void Simulation::RecalcFreeParticles(bool do_life_dec)
 			parts[lastPartUnused].life = parts_lastActiveIndex+1;
 	}
 	parts_lastActiveIndex = lastPartUsed;
+	subframeOrderStale = false;
 	if (elementRecount)
 		elementRecount = false;
+
+	// past this many cells, clearing the whole maps at once is cheaper than going cell by cell
+	if (pmapDirtyCells.size() > XRES*YRES/16)
+		all = true;
+	if (all || pmapDirtyCells.size())
+		RebuildPmap(all, killed, lastIndex);
+#ifdef DEBUG
+	if (!all)
+	{
+		// check the repaired maps against a full rebuild, which also leaves them right if they weren't
+		std::vector<int> checkPmap(&pmap[0][0], &pmap[0][0] + XRES*YRES);
+		std::vector<int> checkPhotons(&photons[0][0], &photons[0][0] + XRES*YRES);
+		std::vector<unsigned int> checkCount(&pmap_count[0][0], &pmap_count[0][0] + XRES*YRES);
+		RebuildPmap(true, killed, lastIndex);
+		for (int cell = 0; cell < XRES*YRES; cell++)
+		{
+			int x = cell % XRES, y = cell / XRES;
+			if (checkPmap[cell] != pmap[y][x] || checkPhotons[cell] != photons[y][x] || checkCount[cell] != pmap_count[y][x])
+			{
+				std::cerr << "Incremental pmap update missed a change at " << x << ", " << y << std::endl;
+				break;
+			}
+		}
+	}
+#endif
+
+	for (auto cell : pmapDirtyCells)
+		pmapDirty[cell / XRES][cell % XRES] = 0;
+	pmapDirtyCells.clear();
+	pmapDirtyAll = false;
+	for (auto i : killed)
+	{
+		// killed after being added to pmap, which leaves a hole that the next rebuild fills in
+		MarkPmapDirty(ID(pmapRecord[i]) % XRES, ID(pmapRecord[i]) / XRES);
+		pmapRecord[i] = -1;
+	}
 }
 
-void Simulation::FixSoapLinks(std::map<unsigned int, unsigned int> &soapList)
+void Simulation::FixSoapLinks(const std::vector<int> &soapRemap)
 {
-	// fix SOAP links using soapList, a map of old particle ID -> new particle ID
+	// fix SOAP links using soapRemap, which maps old particle ID -> new particle ID (or -1 if it wasn't SOAP)
 	// loop through every old particle (loaded from save), and convert .tmp / .tmp2
-	for (std::map<unsigned int, unsigned int>::iterator iter = soapList.begin(), end = soapList.end(); iter != end; ++iter)
+	int remapSize = int(soapRemap.size());
+	for (int oldId = 0; oldId < remapSize; oldId++)
 	{
-		int i = (*iter).second;
+		int i = soapRemap[oldId];
+		if (i < 0)
+			continue;
 		if ((parts[i].ctype & 0x2) == 2)
 		{
-			std::map<unsigned int, unsigned int>::iterator n = soapList.find(parts[i].tmp);
-			if (n != end)
-				parts[i].tmp = n->second;
+			int tmp = parts[i].tmp;
+			if (tmp >= 0 && tmp < remapSize && soapRemap[tmp] >= 0)
+				parts[i].tmp = soapRemap[tmp];
 			// sometimes the proper SOAP isn't found. It should remove the link, but seems to break some saves
 			// so just ignore it
 		}
 		if ((parts[i].ctype & 0x4) == 4)
 		{
-			std::map<unsigned int, unsigned int>::iterator n = soapList.find(parts[i].tmp2);
-			if (n != end)
-				parts[i].tmp2 = n->second;
+			int tmp2 = parts[i].tmp2;
+			if (tmp2 >= 0 && tmp2 < remapSize && soapRemap[tmp2] >= 0)
+				parts[i].tmp2 = soapRemap[tmp2];
 			// sometimes the proper SOAP isn't found. It should remove the link, but seems to break some saves
 			// so just ignore it
 		}
 	}
 }
 
+// Moves the particles in stackReorderParts[0, count) to the front of parts, and clears
+// whatever was left behind up to the old parts_lastActiveIndex. Slots past that are already empty.
+void Simulation::CompactReorderedParts(int count)
+{
+	memcpy(parts, stackReorderParts, sizeof(Particle) * count);
+	if (count <= parts_lastActiveIndex)
+		memset(&parts[count], 0, sizeof(Particle) * (parts_lastActiveIndex + 1 - count));
+}
+
 void Simulation::ReloadParticleOrder()
 {
 	CompleteDebugUpdateParticles();
-	// use pmap_count as count buffer
-	memset(pmap_count, 0, sizeof(pmap_count));
-	memset(stackReorderParts, 0, sizeof(stackReorderParts));
-	for (int i = 0; i <= parts_lastActiveIndex; i++)
+	// nothing to do if the particles are in order and already packed at the front
+	// (stack edits leave them in order at the back, which still wants compacting).
+	// Check the order here rather than trust subframeOrderBreaks, and look for holes
+	// rather than compare NUM_PARTS, kill_part doesn't lower it
+	bool packed = true;
+	int64_t lastKey = noSubframeOrderKey;
+	for (int i = 0; packed && i <= parts_lastActiveIndex; i++)
 	{
-		if (!parts[i].type)
-			continue;
 		int partx = (int)(parts[i].x+0.5f);
 		int party = (int)(parts[i].y+0.5f);
-		if (partx<CELL || partx>=XRES-CELL || party<CELL || party>=YRES-CELL)
-			kill_part(i);
-		pmap_count[party][partx]++;
-	}
-	int runningCount = 0;
-	for (int y = 0; y < YRES; y++)
-	{
-		for (int x = 0; x < XRES; x++)
+		// the reload below would kill particles in the border
+		if (!parts[i].type || partx<CELL || partx>=XRES-CELL || party<CELL || party>=YRES-CELL)
+			packed = false;
+		else
 		{
-			int startId = runningCount;
-			runningCount += pmap_count[y][x];
-			pmap_count[y][x] = startId;
+			int64_t key = SubframeOrderKey(parts[i]);
+			if (key < lastKey)
+				packed = false;
+			lastKey = key;
 		}
 	}
-	std::map<unsigned int, unsigned int> soapList;
+	if (packed)
+	{
+		needReloadParticleOrder = false;
+		return;
+	}
+	std::vector<int> order;
+	order.reserve(NUM_PARTS);
 	for (int i = 0; i <= parts_lastActiveIndex; i++)
 	{
 		if (!parts[i].type)
 			continue;
 		int partx = (int)(parts[i].x+0.5f);
 		int party = (int)(parts[i].y+0.5f);
-		int newId = pmap_count[party][partx];
-		pmap_count[party][partx] = newId + 1;
+		if (partx<CELL || partx>=XRES-CELL || party<CELL || party>=YRES-CELL)
+		{
+			kill_part(i);
+			continue;
+		}
+		order.push_back(i);
+	}
+	// stable counting sort by column, then by row, so particles in the same position
+	// keep their stacking order
+	std::vector<int> byColumn(order.size());
+	std::vector<int> start(std::max(XRES, YRES) + 1);
+	auto countingPass = [this, &start](const std::vector<int> &from, std::vector<int> &to, bool rows) {
+		std::fill(start.begin(), start.end(), 0);
+		for (int i : from)
+			start[(int)((rows ? parts[i].y : parts[i].x)+0.5f) + 1]++;
+		for (size_t pos = 1; pos < start.size(); pos++)
+			start[pos] += start[pos - 1];
+		for (int i : from)
+			to[start[(int)((rows ? parts[i].y : parts[i].x)+0.5f)]++] = i;
+	};
+	countingPass(order, byColumn, false);
+	countingPass(byColumn, order, true);
+	std::vector<int> soapRemap(parts_lastActiveIndex + 1, -1);
+	int count = int(order.size());
+	for (int newId = 0; newId < count; newId++)
+	{
+		int i = order[newId];
 		stackReorderParts[newId] = parts[i];
 		if (parts[i].type == PT_SOAP)
-			soapList.insert(std::pair<unsigned int, unsigned int>(i, newId));
+			soapRemap[i] = newId;
 	}
-	memcpy(parts, stackReorderParts, sizeof(parts));
-	FixSoapLinks(soapList);
-	parts_lastActiveIndex = NPART-1;
+	CompactReorderedParts(count);
+	FixSoapLinks(soapRemap);
 	RecalcFreeParticles(false);
 	needReloadParticleOrder = false;
 }
@@ -4989,18 +5655,27 @@ void Simulation::BeforeStackEdit()
 	if (stackEditDepth < 0)
 		return;
 	CompleteDebugUpdateParticles();
-	// use pmap_count as count buffer
-	memset(pmap_count, 0, sizeof(pmap_count));
-	memset(stackReorderParts, 0, sizeof(stackReorderParts));
-	int numInBack = 0;
-	for (int i = parts_lastActiveIndex; i >= 0; i--)
+	// use pmap_count as count buffer, clearing only the cells that are about to be counted
+	for (int i = 0; i <= parts_lastActiveIndex; i++)
 	{
 		if (!parts[i].type)
 			continue;
 		int partx = (int)(parts[i].x+0.5f);
 		int party = (int)(parts[i].y+0.5f);
 		if (partx<CELL || partx>=XRES-CELL || party<CELL || party>=YRES-CELL)
+		{
 			kill_part(i);
+			continue;
+		}
+		pmap_count[party][partx] = 0;
+	}
+	int numInBack = 0;
+	for (int i = parts_lastActiveIndex; i >= 0; i--)
+	{
+		if (!parts[i].type)
+			continue;
+		int partx = (int)(parts[i].x+0.5f);
+		int party = (int)(parts[i].y+0.5f);
 		if ((int)pmap_count[party][partx] <= stackEditDepth)
 			numInBack++;
 		pmap_count[party][partx]++;
@@ -5008,7 +5683,7 @@ void Simulation::BeforeStackEdit()
 	int frontPtr = 0, backPtr = NPART - numInBack;
 	int backBegin = backPtr;
 
-	std::map<unsigned int, unsigned int> soapList;
+	std::vector<int> soapRemap(parts_lastActiveIndex + 1, -1);
 	for (int i = 0; i <= parts_lastActiveIndex; i++)
 	{
 		if (!parts[i].type)
@@ -5024,10 +5699,13 @@ void Simulation::BeforeStackEdit()
 			backPtr++;
 		stackReorderParts[newId] = parts[i];
 		if (parts[i].type == PT_SOAP)
-			soapList.insert(std::pair<unsigned int, unsigned int>(i, newId));
+			soapRemap[i] = newId;
 	}
-	memcpy(parts, stackReorderParts, sizeof(parts));
-	FixSoapLinks(soapList);
+	// the front particles can't reach backBegin, so copying them first leaves
+	// the back ones in stackReorderParts untouched
+	CompactReorderedParts(frontPtr);
+	memcpy(&parts[backBegin], &stackReorderParts[backBegin], sizeof(Particle) * numInBack);
+	FixSoapLinks(soapRemap);
 	parts_lastActiveIndex = NPART-1;
 	RecalcFreeParticles(false);
 
@@ -5048,6 +5726,7 @@ void Simulation::BeforeStackEdit()
 		pmap[y][x] = PMAP(i, t);
 		photons[y][x] = PMAP(i, t);
 	}
+	pmapDirtyAll = true;
 	needReloadParticleOrder = true;
 }
 
@@ -5078,13 +5757,107 @@ int Simulation::GetStackEditParticleId(int x, int y)
 	return latesti;
 }
 
-void Simulation::SimulateGoL()
+// Adds each bit of a packed GOL row to its left and right neighbours, or just adds the
+// neighbours, giving two-bit sums in sum1:sum0
+static void GolRowSums(const uint32_t *row, bool withCentre, uint32_t *sum0, uint32_t *sum1)
 {
-	CGOL = 0;
+	for (int w = 0; w < Simulation::golRowWords; ++w)
+	{
+		uint32_t centre = row[w];
+		uint32_t left = (centre << 1) | (w > 0 ? row[w - 1] >> 31 : 0U);
+		uint32_t right = (centre >> 1) | (w + 1 < Simulation::golRowWords ? row[w + 1] << 31 : 0U);
+		if (withCentre)
+		{
+			sum0[w] = left ^ centre ^ right;
+			sum1[w] = (left & centre) | (left & right) | (centre & right);
+		}
+		else
+		{
+			sum0[w] = left ^ right;
+			sum1[w] = left & right;
+		}
+	}
+}
+
+bool Simulation::SimulateGoLPacked()
+{
+	// * Handles the common case of every LIFE particle in the GOL space having the same ctype
+	//   and being alone in its cell, with the same results as SimulateGoLNeighbourLists.
+	//   With only one kind of cell around, the population contest always goes to that kind
+	//   and a neighbour list boils down to a neighbour count, which is then summed up for 32
+	//   cells at a time from bit planes of living cells.
+	constexpr int golWidth = XRES - 2 * CELL;
+	constexpr int golHeight = YRES - 2 * CELL;
+	std::fill(&golAlive[0][0], &golAlive[0][0] + golHeight * golRowWords, 0U);
+	std::fill(&golOccupied[0][0], &golOccupied[0][0] + golHeight * golRowWords, 0U);
+	bool anyLife = false;
+	int golCtype = 0;
+	unsigned int ruleset = 0;
+	int liveTmp2 = 0;
+	for (int i = 0; i <= parts_lastActiveIndex; ++i)
+	{
+		if (partsType[i] != PT_LIFE)
+		{
+			continue;
+		}
+		auto &part = parts[i];
+		auto x = int(part.x + 0.5f);
+		auto y = int(part.y + 0.5f);
+		if (x < CELL || y < CELL || x >= XRES - CELL || y >= YRES - CELL)
+		{
+			continue;
+		}
+		if (!anyLife)
+		{
+			// * A custom ruleset numbered exactly NGOL would be mistaken for the last
+			//   built-in one when decoded from a neighbour list (built-in ones are stored
+			//   one up), and one wider than 21 bits would be cut short; leave those to
+			//   the lists too.
+			unsigned int golnum = part.ctype;
+			if (golnum == NGOL || golnum > 0x001FFFFFU)
+			{
+				return false;
+			}
+			anyLife = true;
+			golCtype = part.ctype;
+			ruleset = golnum < NGOL ? builtinGol[golnum].ruleset : golnum;
+			liveTmp2 = int((ruleset >> 17) & 0xF) + 1;
+		}
+		if (part.ctype != golCtype || pmap[y][x] != PMAP(i, PT_LIFE))
+		{
+			return false;
+		}
+		int b = x - CELL + 1;
+		golOccupied[y - CELL][b / 32] |= 1U << (b % 32);
+		if (part.tmp2 == liveTmp2)
+		{
+			golAlive[y - CELL][b / 32] |= 1U << (b % 32);
+		}
+	}
+	if (!anyLife)
+	{
+		return true;
+	}
+	for (int gy = 0; gy < golHeight; ++gy)
+	{
+		auto *row = golAlive[gy];
+		if ((row[golWidth / 32] >> (golWidth % 32)) & 1)
+		{
+			row[0] |= 1U;
+		}
+		if (row[0] & 2U)
+		{
+			row[(golWidth + 1) / 32] |= 1U << ((golWidth + 1) % 32);
+		}
+	}
 	for (int i = 0; i <= parts_lastActiveIndex; ++i)
 	{
+		if (partsType[i] != PT_LIFE)
+		{
+			continue;
+		}
 		auto &part = parts[i];
-		if (part.type != PT_LIFE)
+		if (part.tmp2 == liveTmp2)
 		{
 			continue;
 		}
@@ -5094,6 +5867,117 @@ void Simulation::SimulateGoL()
 		{
 			continue;
 		}
+		if (!(bmap[y / CELL][x / CELL] == WL_STASIS && emap[y / CELL][x / CELL] < 8))
+		{
+			part.tmp2 -= 1;
+		}
+	}
+	auto alive = [this](int x, int y) {
+		int b = x - CELL + 1;
+		return (golAlive[y - CELL][b / 32] >> (b % 32)) & 1;
+	};
+	for (int gy = 0; gy < golHeight; ++gy)
+	{
+		uint32_t above0[golRowWords], above1[golRowWords];
+		uint32_t level0[golRowWords], level1[golRowWords];
+		uint32_t below0[golRowWords], below1[golRowWords];
+		GolRowSums(golAlive[(gy + golHeight - 1) % golHeight], true, above0, above1);
+		GolRowSums(golAlive[gy], false, level0, level1);
+		GolRowSums(golAlive[(gy + 1) % golHeight], true, below0, below1);
+		for (int w = 0; w < golRowWords; ++w)
+		{
+			// * Neighbour count in bits n3:n2:n1:n0, from adding up the three two-bit sums.
+			uint32_t carry = above0[w] & level0[w];
+			uint32_t s0 = above0[w] ^ level0[w];
+			uint32_t s1 = above1[w] ^ level1[w] ^ carry;
+			uint32_t s2 = (above1[w] & level1[w]) | (carry & (above1[w] ^ level1[w]));
+			carry = s0 & below0[w];
+			uint32_t n0 = s0 ^ below0[w];
+			uint32_t n1 = s1 ^ below1[w] ^ carry;
+			carry = (s1 & below1[w]) | (carry & (s1 ^ below1[w]));
+			uint32_t n2 = s2 ^ carry;
+			uint32_t n3 = s2 & carry;
+			uint32_t valid = ~0U;
+			if (w == 0)
+			{
+				valid &= ~1U;
+			}
+			int lastBit = golWidth - w * 32;
+			if (lastBit < 31)
+			{
+				valid &= (2U << lastBit) - 1U;
+			}
+			uint32_t todo = (n0 | n1 | n2 | n3 | golOccupied[gy][w]) & valid;
+			while (todo)
+			{
+				int bit = __builtin_ctz(todo);
+				todo &= todo - 1U;
+				int x = w * 32 + bit - 1 + CELL;
+				int y = gy + CELL;
+				int r = pmap[y][x];
+				if (r && TYP(r) != PT_LIFE)
+				{
+					continue;
+				}
+				if (bmap[y / CELL][x / CELL] == WL_STASIS && emap[y / CELL][x / CELL] < 8)
+				{
+					continue;
+				}
+				unsigned int neighbours = ((n0 >> bit) & 1) | (((n1 >> bit) & 1) << 1) | (((n2 >> bit) & 1) << 2) | (((n3 >> bit) & 1) << 3);
+				if (r)
+				{
+					auto &part = parts[ID(r)];
+					if (!((ruleset >> neighbours) & 1) && part.tmp2 == int(ruleset >> 17) + 1)
+					{
+						// * Start death sequence.
+						part.tmp2 -= 1;
+					}
+				}
+				else if ((ruleset >> (neighbours + 8)) & 1)
+				{
+					// * The neighbour list would have been started by the living neighbour
+					//   that comes first in the particle list; that is the one to sample.
+					int sampleID = NPART;
+					for (int yy = -1; yy <= 1; ++yy)
+					{
+						for (int xx = -1; xx <= 1; ++xx)
+						{
+							int ax = ((x + xx + XRES - 3 * CELL) % (XRES - 2 * CELL)) + CELL;
+							int ay = ((y + yy + YRES - 3 * CELL) % (YRES - 2 * CELL)) + CELL;
+							if ((xx || yy) && alive(ax, ay))
+							{
+								sampleID = std::min(sampleID, int(ID(pmap[ay][ax])));
+							}
+						}
+					}
+					int i = create_part(-1, x, y, PT_LIFE, golCtype | 0x200000);
+					if (i >= 0)
+					{
+						parts[i].dcolour = parts[sampleID].dcolour;
+						parts[i].tmp = parts[sampleID].tmp;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+void Simulation::SimulateGoLNeighbourLists()
+{
+	for (int i = 0; i <= parts_lastActiveIndex; ++i)
+	{
+		if (partsType[i] != PT_LIFE)
+		{
+			continue;
+		}
+		auto &part = parts[i];
+		auto x = int(part.x + 0.5f);
+		auto y = int(part.y + 0.5f);
+		if (x < CELL || y < CELL || x >= XRES - CELL || y >= YRES - CELL)
+		{
+			continue;
+		}
 		unsigned int golnum = part.ctype;
 		unsigned int ruleset = golnum;
 		if (golnum < NGOL)
@@ -5241,6 +6125,15 @@ void Simulation::SimulateGoL()
 			}
 		}
 	}
+}
+
+void Simulation::SimulateGoL()
+{
+	CGOL = 0;
+	if (!SimulateGoLPacked())
+	{
+		SimulateGoLNeighbourLists();
+	}
 	for (int y = CELL; y < YRES - CELL; ++y)
 	{
 		for (int x = CELL; x < XRES - CELL; ++x)
@@ -5273,12 +6166,14 @@ void Simulation::CheckStacking()
 					{
 						pmap_count[y][x] = pmap_count[y][x] + NPART;
 						excessive_stacking_found = 1;
+						MarkPmapDirty(x, y);
 					}
 				}
-				else if (pmap_count[y][x]>1500 || (unsigned int)RNG::Ref().between(0, 1599) <= (pmap_count[y][x]+100))
+				else if (pmap_count[y][x]>1500 || (unsigned int)rng.between(0, 1599) <= (pmap_count[y][x]+100))
 				{
 					pmap_count[y][x] = pmap_count[y][x] + NPART;
 					excessive_stacking_found = true;
+					MarkPmapDirty(x, y);
 				}
 			}
 		}
@@ -5320,6 +6215,11 @@ void Simulation::BeforeSim()
 {
 	if (!sys_pause||framerender)
 	{
+		if (profiler.enabled)
+		{
+			profiler.frames++;
+			profiler.Begin(SimulationProfiler::BeforeSim);
+		}
 		air->update_air();
 
 		if(aheat_enable)
@@ -5376,7 +6276,7 @@ void Simulation::BeforeSim()
 		}
 
 		// check for stacking and create BHOL if found
-		if (force_stacking_check || RNG::Ref().chance(1, 10))
+		if (force_stacking_check || rng.chance(1, 10))
 		{
 			CheckStacking();
 		}
@@ -5472,7 +6372,7 @@ void Simulation::BeforeSim()
 		{
 			for (int i = 0; i <= parts_lastActiveIndex; i++)
 			{
-				if (parts[i].type==PT_PPIP)
+				if (partsType[i]==PT_PPIP)
 				{
 					parts[i].tmp |= (parts[i].tmp&0xE0000000)>>3;
 					parts[i].tmp &= ~0xE0000000;
@@ -5505,12 +6405,16 @@ void Simulation::BeforeSim()
 		if (!player2.spwn && player2.spawnID >= 0)
 			create_part(-1, (int)parts[player2.spawnID].x, (int)parts[player2.spawnID].y, PT_STKM2);
 
+		if (profiler.enabled)
+			profiler.End();
 		// particle update happens right after this function (called separately)
 	}
 }
 
 void Simulation::AfterSim()
 {
+	if (profiler.enabled)
+		profiler.Begin(SimulationProfiler::AfterSim);
 	if (emp_trigger_count)
 	{
 		// pitiful attempt at trying to keep code relating to a given element in the same file
@@ -5527,6 +6431,8 @@ void Simulation::AfterSim()
 			subframe_mode = false;
 		}
 	}
+	if (profiler.enabled)
+		profiler.End();
 }
 
 Simulation::~Simulation()
@@ -5543,7 +6449,14 @@ Simulation::Simulation():
 	stackToolNotifShown(false),
 	debug_currentParticle(0),
 	debug_interestingChangeOccurred(false),
+	debug_stepping(false),
+	debug_breakpointHit(NPART),
+	skipSettledParticles(false),
+	settledTemp(-1.0f),
+	settledTempFixed(false),
 	needReloadParticleOrder(false),
+	subframeOrderBreaks(0),
+	subframeOrderStale(false),
 	ISWIRE(0),
 	force_stacking_check(false),
 	emp_decor(0),
@@ -5554,6 +6467,8 @@ Simulation::Simulation():
 	gravWallChanged(false),
 	CGOL(0),
 	GSPEED(1),
+	incrementalPmap(true),
+	pmapDirtyAll(true),
 	edgeMode(0),
 	gravityMode(0),
 	legacy_enable(0),
@@ -5576,6 +6491,9 @@ Simulation::Simulation():
 	currentTick = 0;
 	std::fill(elementCount, elementCount+PT_NUM, 0);
 	elementRecount = true;
+	memset(pmapDirty, 0, sizeof(pmapDirty));
+	std::fill(pmapRecord, pmapRecord+NPART, -1);
+	std::fill(subframeOrderKey, subframeOrderKey+NPART, noSubframeOrderKey);
 
 	//Create and attach gravity simulation
 	grav = new Gravity();
@@ -4,6 +4,7 @@
 
 #include <cstring>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <array>
@@ -14,13 +15,18 @@
 #include "WallType.h"
 #include "Sign.h"
 #include "ElementDefs.h"
+#include "SimulationData.h"
 #include "BuiltinGOL.h"
 #include "MenuSection.h"
 #include "CoordStack.h"
 #include "Sample.h"
+#include "ParticleBreakpoint.h"
+#include "SimulationProfiler.h"
 
 #include "Element.h"
 
+#include "common/tpt-rand.h"
+
 #define CHANNELS ((int)(MAX_TEMP-73)/100+2)
 
 class Snapshot;
@@ -51,6 +57,9 @@ public:
 	std::vector<menu_section> msections;
 
 	int currentTick;
+	// per-simulation random number generator; saved in snapshots and saves
+	// so that replays don't depend on what else is running in the process
+	RNG rng;
 	int replaceModeSelected;
 	int replaceModeFlags;
 
@@ -70,9 +79,33 @@ public:
 	int stackToolNotifShownY;
 
 	char can_move[PT_NUM][PT_NUM];
+	// Whether a particle of some type gets killed inside some wall, see init_wall_kill
+	unsigned char wall_kill[PT_NUM][UI_WALLCOUNT];
 	int debug_currentParticle;
 	bool debug_interestingChangeOccurred;
+	// Checked by UpdateParticles while StepParticles runs it, see ParticleBreakpoint
+	std::vector<ParticleBreakpoint> debug_breakpoints;
+	std::vector<ParticleBreakpointHit> debug_breakpointHits;
+	bool debug_stepping;
+	int debug_breakpointHit;
+	SimulationProfiler profiler;
+	// Whether UpdateParticles cuts short the update of particles that IsSettled finds
+	// settled. The result is the same either way, it's only faster with this on.
+	bool skipSettledParticles;
+	// Whether particles of some type can be settled at all, see init_settleable
+	bool settleable[PT_NUM];
+	// The last temperature IsHeatSettled checked for being a fixed point of heat conduction
+	float settledTemp;
+	bool settledTempFixed;
 	bool needReloadParticleOrder;
+	// Number of particles positioned before the previous particle, so zero when the particles
+	// are in subframe order. Every particle's position is recorded in subframeOrderKey; the
+	// functions that create, kill and move particles call UpdateSubframeOrder to keep the
+	// count current, and RecalcFreeParticles recounts it every frame, catching anything else.
+	// While subframeOrderStale is set the count is recomputed the next time it is needed.
+	int subframeOrderBreaks;
+	bool subframeOrderStale;
+	int64_t subframeOrderKey[NPART];
 	int parts_lastActiveIndex;
 	int pfree;
 	int NUM_PARTS;
@@ -100,6 +133,12 @@ public:
 	int CGOL;
 	int GSPEED;
 	unsigned int gol[YRES][XRES][5];
+	// Bit planes used by SimulateGoLPacked, one row of bits per row of the GOL space. Bit x+1
+	// stands for the cell at x+CELL; bits 0 and XRES-2*CELL+1 repeat the cells on the opposite
+	// edge, so neighbours across the wraparound can be reached with plain shifts.
+	static constexpr int golRowWords = (XRES - 2 * CELL + 2 + 31) / 32;
+	uint32_t golAlive[YRES - 2 * CELL][golRowWords];
+	uint32_t golOccupied[YRES - 2 * CELL][golRowWords];
 	//Air sim
 	float (*vx)[XRES/CELL];
 	float (*vy)[XRES/CELL];
@@ -120,6 +159,21 @@ public:
 	int pmap[YRES][XRES];
 	int photons[YRES][XRES];
 	unsigned int pmap_count[YRES][XRES];
+	// Cells whose pmap, photons and pmap_count entries may not match what a full rebuild
+	// would produce. RecalcFreeParticles only rebuilds these every frame, so anything that
+	// writes to pmap or photons outside of it needs to call MarkPmapDirty.
+	bool incrementalPmap;
+	bool pmapDirtyAll;
+	unsigned char pmapDirty[YRES][XRES];
+	std::vector<int> pmapDirtyCells;
+	// Where RecalcFreeParticles last found each particle, as PMAP(y*XRES+x, type), or -1
+	int pmapRecord[NPART];
+	// Column copy of parts[i].type, for passes that only look for particles of a few types and
+	// would otherwise drag all of parts through the cache. RecalcFreeParticles rebuilds it and
+	// create_part, kill_part and part_change_type keep it current, but code that writes types
+	// directly (element update functions, tools, Lua) doesn't, so it is only to be relied on in
+	// BeforeSim, between RecalcFreeParticles and the particle update.
+	uint16_t partsType[NPART];
 	//Simulation Settings
 	int edgeMode;
 	int gravityMode;
@@ -143,8 +197,11 @@ public:
 	void UpdateSample(int x, int y);
 	int GetStackEditPartId(); // returns -1 if no particles exist in sample
 
-	std::unique_ptr<Snapshot> CreateSnapshot();
+	std::unique_ptr<Snapshot> CreateSnapshot(std::unique_ptr<Snapshot> reuse = nullptr);
 	void Restore(const Snapshot &snap);
+	// Copies everything a Renderer reads from source, so that a renderer attached to this
+	// simulation can draw source's current state while source goes on changing
+	void CopyRenderState(const Simulation &source);
 
 	int is_blocking(int t, int x, int y);
 	int is_boundary(int pt, int x, int y);
@@ -155,6 +212,8 @@ public:
 	int try_move(int i, int x, int y, int nx, int ny);
 	int eval_move(int pt, int nx, int ny, unsigned *rr);
 	void init_can_move();
+	void init_wall_kill();
+	void init_settleable();
 	bool IsWallBlocking(int x, int y, int type);
 	bool IsElement(int type) const {
 		return (type > 0 && type < PT_NUM && elements[type].Enabled);
@@ -181,12 +240,42 @@ public:
 	void set_emap(int x, int y);
 	int parts_avg(int ci, int ni, int t);
 	void create_arc(int sx, int sy, int dx, int dy, int midpoints, int variance, int type, int flags);
+	// Hash of everything a frame can change that matters for comparing two runs: particles,
+	// pmap, air, gravity, walls and the random number generator. Recomputed from scratch
+	// every call rather than kept up to date incrementally, as these are written directly
+	// from elements, tools and Lua, none of which would report their changes. At memory
+	// bandwidth it is still cheap enough to take every frame, or after stopping between
+	// particles.
+	uint64_t StateHash() const;
 	bool AreParticlesInSubframeOrder();
+	int GetSubframeOrderBreaks();
+	void UpdateSubframeOrder(int i);
+	void RecountSubframeOrder();
 	void CompleteDebugUpdateParticles();
+	void AddBreakpoint(ParticleBreakpoint breakpoint);
+	bool CheckBreakpoints(int i, int writer, int writerType);
+	int WatchedParticle(const ParticleBreakpoint &breakpoint);
+	int StepParticles();
 	void UpdateParticles(int start, int end);
 	void SimulateGoL();
+	bool SimulateGoLPacked();
+	void SimulateGoLNeighbourLists();
+	void MarkPmapDirty(int x, int y)
+	{
+		if (!pmapDirty[y][x])
+		{
+			pmapDirty[y][x] = 1;
+			pmapDirtyCells.push_back(y*XRES+x);
+		}
+	}
+	void AddToPmap(int i, int t, int x, int y);
+	void RebuildPmap(bool all, const std::vector<int> &killed, int lastIndex);
+	bool DecreaseLife(int i, int t, int x, int y, bool inBounds);
+	bool IsSettled(int i, int t, int x, int y);
+	bool IsHeatSettled(int i, int x, int y);
 	void RecalcFreeParticles(bool do_life_dec);
-	void FixSoapLinks(std::map<unsigned int, unsigned int> &soapList);
+	void FixSoapLinks(const std::vector<int> &soapRemap);
+	void CompactReorderedParts(int count);
 	void ReloadParticleOrder();
 	// run BeforeStackEdit before drawing to target the stack edit depth;
 	// run AfterStackEdit when done
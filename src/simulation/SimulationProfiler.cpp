@@ -0,0 +1,61 @@
+#include "SimulationProfiler.h"
+
+#include "Element.h"
+
+#include <algorithm>
+
+const char *SimulationProfiler::PhaseName(int phase)
+{
+	static const char *names[PhaseCount] = {
+		"BeforeSim", "Walls", "Air", "Velocity", "Heat", "Transitions", "Update", "Movement", "AfterSim",
+	};
+	return names[phase];
+}
+
+const char *SimulationProfiler::CounterName(int counter)
+{
+	static const char *names[CounterCount] = {
+		"create_part", "kill_part", "part_change_type", "try_move",
+	};
+	return names[counter];
+}
+
+void SimulationProfiler::Reset()
+{
+	frames = 0;
+	std::fill(phaseTicks, phaseTicks + PhaseCount, 0);
+	std::fill(elementTicks, elementTicks + PT_NUM, 0);
+	std::fill(elementUpdates, elementUpdates + PT_NUM, 0);
+	std::fill(counters, counters + CounterCount, 0);
+}
+
+uint64_t SimulationProfiler::TotalTicks() const
+{
+	uint64_t total = 0;
+	for (int phase = 0; phase < PhaseCount; phase++)
+		total += phaseTicks[phase];
+	return total;
+}
+
+ByteString SimulationProfiler::Report(const Element *elements) const
+{
+	ByteStringBuilder report;
+#ifdef PROFILER_CYCLE_COUNTER
+	report << "# ticks are TSC cycles\n";
+#else
+	report << "# ticks are nanoseconds\n";
+#endif
+	report << "frames\t" << frames << "\n";
+	report << "total\t" << TotalTicks() << "\n";
+	for (int phase = 0; phase < PhaseCount; phase++)
+		report << "phase\t" << PhaseName(phase) << "\t" << phaseTicks[phase] << "\n";
+	for (int counter = 0; counter < CounterCount; counter++)
+		report << "calls\t" << CounterName(counter) << "\t" << counters[counter] << "\n";
+	for (int t = 0; t < PT_NUM; t++)
+	{
+		// elementTicks[0] is time spent outside any particle's update, already covered by the phases
+		if (t && elementUpdates[t])
+			report << "element\t" << elements[t].Name.ToUtf8() << "\t" << elementTicks[t] << "\t" << elementUpdates[t] << "\n";
+	}
+	return report.Build();
+}
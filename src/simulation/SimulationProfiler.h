@@ -0,0 +1,118 @@
+#ifndef SIMULATIONPROFILER_H
+#define SIMULATIONPROFILER_H
+
+#include "ElementDefs.h"
+#include "common/String.h"
+
+#include <cstdint>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+# ifdef _MSC_VER
+#  include <intrin.h>
+# else
+#  include <x86intrin.h>
+# endif
+# define PROFILER_CYCLE_COUNTER
+#endif
+
+class Element;
+
+// Optional instrumentation of Simulation::UpdateParticles. While enabled, the particle loop
+// marks the start of each phase of a particle's update; the ticks between two marks are
+// added to the phase that was running and to the type the particle had when its update
+// started. Ticks are TSC cycles on x86 and nanoseconds elsewhere. BeforeSim and AfterSim
+// are timed as a whole. Nothing is touched while disabled apart from the checks of enabled.
+class SimulationProfiler
+{
+public:
+	enum Phase
+	{
+		BeforeSim,
+		Walls,       // wall and stasis checks
+		Air,         // air drag and hot air
+		Velocity,    // gravity, loss, advection and diffusion
+		Heat,        // convection and conduction
+		Transitions, // temperature, pressure and gravity transitions
+		Update,      // element update functions, including Lua ones
+		Movement,
+		AfterSim,
+		PhaseCount,
+	};
+
+	enum Counter
+	{
+		CreatePart,
+		KillPart,
+		PartChangeType,
+		TryMove,
+		CounterCount,
+	};
+
+	static const char *PhaseName(int phase);
+	static const char *CounterName(int counter);
+
+	static uint64_t Ticks()
+	{
+#ifdef PROFILER_CYCLE_COUNTER
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	bool enabled = false;
+	int frames = 0;
+	uint64_t phaseTicks[PhaseCount] = {};
+	uint64_t elementTicks[PT_NUM] = {};
+	uint64_t elementUpdates[PT_NUM] = {};
+	uint64_t counters[CounterCount] = {};
+
+	void Reset();
+
+	void Begin(Phase phase)
+	{
+		currentPhase = phase;
+		currentType = 0;
+		lastTicks = Ticks();
+	}
+
+	// Starts the update of a particle of type t
+	void Mark(Phase phase, int t)
+	{
+		Mark(phase);
+		currentType = t;
+		elementUpdates[t]++;
+	}
+
+	void Mark(Phase phase)
+	{
+		auto now = Ticks();
+		phaseTicks[currentPhase] += now - lastTicks;
+		elementTicks[currentType] += now - lastTicks;
+		currentPhase = phase;
+		lastTicks = now;
+	}
+
+	void End()
+	{
+		auto now = Ticks();
+		phaseTicks[currentPhase] += now - lastTicks;
+		elementTicks[currentType] += now - lastTicks;
+	}
+
+	void Count(Counter counter)
+	{
+		counters[counter]++;
+	}
+
+	uint64_t TotalTicks() const;
+	// Tab separated, one line per phase, counter and updated element
+	ByteString Report(const Element *elements) const;
+
+private:
+	Phase currentPhase = BeforeSim;
+	int currentType = 0;
+	uint64_t lastTicks = 0;
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "Sign.h"
 #include "Stickman.h"
 #include "json/json.h"
+#include "common/tpt-rand.h"
 
 class Snapshot
 {
@@ -36,6 +37,8 @@ public:
 	std::vector<playerst> stickmen;
 	std::vector<sign> signs;
 
+	RNG::State RngState;
+
 	Json::Value Authors;
 
 	Snapshot() :
@@ -56,7 +59,8 @@ public:
 		PortalParticles(),
 		WirelessData(),
 		stickmen(),
-		signs()
+		signs(),
+		RngState()
 	{
 
 	}
@@ -65,4 +69,17 @@ public:
 	{
 
 	}
+
+	// * Approximate memory usage, not counting signs and Authors.
+	size_t ByteSize() const
+	{
+		return sizeof(Snapshot) +
+		       sizeof(float) * (AirPressure.size() + AirVelocityX.size() + AirVelocityY.size() + AmbientHeat.size()) +
+		       sizeof(Particle) * (Particles.size() + PortalParticles.size()) +
+		       sizeof(float) * (GravVelocityX.size() + GravVelocityY.size() + GravValue.size() + GravMap.size()) +
+		       BlockMap.size() + ElecMap.size() +
+		       sizeof(float) * (FanVelocityX.size() + FanVelocityY.size()) +
+		       sizeof(int) * WirelessData.size() +
+		       sizeof(playerst) * stickmen.size();
+	}
 };
@@ -0,0 +1,153 @@
+#include "SnapshotCompression.h"
+
+#include <stdexcept>
+#include <zlib.h>
+
+std::vector<char> SnapshotPacker::Compress() const
+{
+	// * The uncompressed size goes first, so SnapshotUnpacker knows how much to allocate.
+	uint64_t rawSize = raw.size();
+	auto bound = compressBound(uLong(rawSize));
+	std::vector<char> compressed(sizeof(rawSize) + bound);
+	std::copy(reinterpret_cast<const char *>(&rawSize), reinterpret_cast<const char *>(&rawSize) + sizeof(rawSize), compressed.begin());
+	auto compressedSize = uLongf(bound);
+	if (compress2(reinterpret_cast<Bytef *>(&compressed[sizeof(rawSize)]), &compressedSize, reinterpret_cast<const Bytef *>(raw.data()), uLong(rawSize), Z_BEST_SPEED) != Z_OK)
+	{
+		throw std::runtime_error("failed to compress snapshot");
+	}
+	compressed.resize(sizeof(rawSize) + compressedSize);
+	compressed.shrink_to_fit();
+	return compressed;
+}
+
+SnapshotUnpacker::SnapshotUnpacker(const std::vector<char> &compressed) : position(0)
+{
+	uint64_t rawSize;
+	std::copy(compressed.begin(), compressed.begin() + sizeof(rawSize), reinterpret_cast<char *>(&rawSize));
+	raw.resize(rawSize);
+	auto uncompressedSize = uLongf(rawSize);
+	if (uncompress(reinterpret_cast<Bytef *>(raw.data()), &uncompressedSize, reinterpret_cast<const Bytef *>(&compressed[sizeof(rawSize)]), uLong(compressed.size() - sizeof(rawSize))) != Z_OK || uncompressedSize != rawSize)
+	{
+		throw std::runtime_error("failed to decompress snapshot");
+	}
+}
+
+CompressedSnapshot::CompressedSnapshot(const Snapshot &snap) :
+	signs(snap.signs),
+	Authors(snap.Authors)
+{
+	SnapshotPacker packer;
+	packer.Put(snap.debug_currentParticle);
+	packer.Put(snap.AirPressure    );
+	packer.Put(snap.AirVelocityX   );
+	packer.Put(snap.AirVelocityY   );
+	packer.Put(snap.AmbientHeat    );
+	packer.Put(snap.Particles      );
+	packer.Put(snap.GravVelocityX  );
+	packer.Put(snap.GravVelocityY  );
+	packer.Put(snap.GravValue      );
+	packer.Put(snap.GravMap        );
+	packer.Put(snap.BlockMap       );
+	packer.Put(snap.ElecMap        );
+	packer.Put(snap.FanVelocityX   );
+	packer.Put(snap.FanVelocityY   );
+	packer.Put(snap.PortalParticles);
+	packer.Put(snap.WirelessData   );
+	packer.Put(snap.stickmen       );
+	packer.Put(snap.RngState       );
+	data = packer.Compress();
+}
+
+std::unique_ptr<Snapshot> CompressedSnapshot::Decompress() const
+{
+	auto ptr = std::make_unique<Snapshot>();
+	auto &snap = *ptr;
+	SnapshotUnpacker unpacker(data);
+	unpacker.Get(snap.debug_currentParticle);
+	unpacker.Get(snap.AirPressure    );
+	unpacker.Get(snap.AirVelocityX   );
+	unpacker.Get(snap.AirVelocityY   );
+	unpacker.Get(snap.AmbientHeat    );
+	unpacker.Get(snap.Particles      );
+	unpacker.Get(snap.GravVelocityX  );
+	unpacker.Get(snap.GravVelocityY  );
+	unpacker.Get(snap.GravValue      );
+	unpacker.Get(snap.GravMap        );
+	unpacker.Get(snap.BlockMap       );
+	unpacker.Get(snap.ElecMap        );
+	unpacker.Get(snap.FanVelocityX   );
+	unpacker.Get(snap.FanVelocityY   );
+	unpacker.Get(snap.PortalParticles);
+	unpacker.Get(snap.WirelessData   );
+	unpacker.Get(snap.stickmen       );
+	unpacker.Get(snap.RngState       );
+	snap.signs = signs;
+	snap.Authors = Authors;
+	return ptr;
+}
+
+size_t CompressedSnapshot::ByteSize() const
+{
+	return sizeof(CompressedSnapshot) + data.size();
+}
+
+CompressedSnapshotDelta::CompressedSnapshotDelta(const SnapshotDelta &delta) :
+	signs(delta.signs),
+	Authors(delta.Authors)
+{
+	SnapshotPacker packer;
+	packer.Put(delta.AirPressure    );
+	packer.Put(delta.AirVelocityX   );
+	packer.Put(delta.AirVelocityY   );
+	packer.Put(delta.AmbientHeat    );
+	packer.Put(delta.commonParticles);
+	packer.Put(delta.extraPartsOld  );
+	packer.Put(delta.extraPartsNew  );
+	packer.Put(delta.GravVelocityX  );
+	packer.Put(delta.GravVelocityY  );
+	packer.Put(delta.GravValue      );
+	packer.Put(delta.GravMap        );
+	packer.Put(delta.BlockMap       );
+	packer.Put(delta.ElecMap        );
+	packer.Put(delta.FanVelocityX   );
+	packer.Put(delta.FanVelocityY   );
+	packer.Put(delta.PortalParticles);
+	packer.Put(delta.WirelessData   );
+	packer.Put(delta.stickmen       );
+	packer.Put(delta.RngState       );
+	data = packer.Compress();
+}
+
+std::unique_ptr<SnapshotDelta> CompressedSnapshotDelta::Decompress() const
+{
+	auto ptr = std::make_unique<SnapshotDelta>();
+	auto &delta = *ptr;
+	SnapshotUnpacker unpacker(data);
+	unpacker.Get(delta.AirPressure    );
+	unpacker.Get(delta.AirVelocityX   );
+	unpacker.Get(delta.AirVelocityY   );
+	unpacker.Get(delta.AmbientHeat    );
+	unpacker.Get(delta.commonParticles);
+	unpacker.Get(delta.extraPartsOld  );
+	unpacker.Get(delta.extraPartsNew  );
+	unpacker.Get(delta.GravVelocityX  );
+	unpacker.Get(delta.GravVelocityY  );
+	unpacker.Get(delta.GravValue      );
+	unpacker.Get(delta.GravMap        );
+	unpacker.Get(delta.BlockMap       );
+	unpacker.Get(delta.ElecMap        );
+	unpacker.Get(delta.FanVelocityX   );
+	unpacker.Get(delta.FanVelocityY   );
+	unpacker.Get(delta.PortalParticles);
+	unpacker.Get(delta.WirelessData   );
+	unpacker.Get(delta.stickmen       );
+	unpacker.Get(delta.RngState       );
+	delta.signs = signs;
+	delta.Authors = Authors;
+	return ptr;
+}
+
+size_t CompressedSnapshotDelta::ByteSize() const
+{
+	return sizeof(CompressedSnapshotDelta) + data.size();
+}
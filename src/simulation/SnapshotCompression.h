@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Snapshot.h"
+#include "SnapshotDelta.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// * Snapshots and SnapshotDeltas in the undo history are kept compressed. Everything except
+//   signs and Authors (which are small, and not plain data) is packed into a flat byte stream
+//   by SnapshotPacker and compressed with zlib at its fastest setting; SnapshotUnpacker reverses
+//   this. Items are read back in the order they were written in.
+class SnapshotPacker
+{
+	std::vector<char> raw;
+
+public:
+	template<class Item>
+	void Put(const Item *items, size_t count)
+	{
+		static_assert(std::is_trivially_copyable<Item>::value, "only plain data can be packed");
+		auto *bytes = reinterpret_cast<const char *>(items);
+		raw.insert(raw.end(), bytes, bytes + count * sizeof(Item));
+	}
+
+	template<class Item>
+	void Put(const Item &item)
+	{
+		Put(&item, 1);
+	}
+
+	template<class Item>
+	void Put(const std::vector<Item> &items)
+	{
+		Put(uint64_t(items.size()));
+		Put(items.data(), items.size());
+	}
+
+	template<class Item>
+	void Put(const SnapshotDelta::HunkVector<Item> &hunks)
+	{
+		Put(uint64_t(hunks.size()));
+		for (auto &hunk : hunks)
+		{
+			Put(hunk.offset);
+			Put(hunk.diffs);
+		}
+	}
+
+	std::vector<char> Compress() const;
+};
+
+class SnapshotUnpacker
+{
+	std::vector<char> raw;
+	size_t position;
+
+public:
+	SnapshotUnpacker(const std::vector<char> &compressed);
+
+	template<class Item>
+	void Get(Item *items, size_t count)
+	{
+		static_assert(std::is_trivially_copyable<Item>::value, "only plain data can be unpacked");
+		std::copy(raw.begin() + position, raw.begin() + position + count * sizeof(Item), reinterpret_cast<char *>(items));
+		position += count * sizeof(Item);
+	}
+
+	template<class Item>
+	void Get(Item &item)
+	{
+		Get(&item, 1);
+	}
+
+	template<class Item>
+	void Get(std::vector<Item> &items)
+	{
+		uint64_t size;
+		Get(size);
+		items.resize(size);
+		Get(items.data(), items.size());
+	}
+
+	template<class Item>
+	void Get(SnapshotDelta::HunkVector<Item> &hunks)
+	{
+		uint64_t size;
+		Get(size);
+		hunks.resize(size);
+		for (auto &hunk : hunks)
+		{
+			Get(hunk.offset);
+			Get(hunk.diffs);
+		}
+	}
+};
+
+class CompressedSnapshot
+{
+	std::vector<char> data;
+	std::vector<sign> signs;
+	Json::Value Authors;
+
+public:
+	CompressedSnapshot(const Snapshot &snap);
+	std::unique_ptr<Snapshot> Decompress() const;
+	size_t ByteSize() const;
+};
+
+class CompressedSnapshotDelta
+{
+	std::vector<char> data;
+	SnapshotDelta::SingleDiff<std::vector<sign>> signs;
+	SnapshotDelta::SingleDiff<Json::Value> Authors;
+
+public:
+	CompressedSnapshotDelta(const SnapshotDelta &delta);
+	std::unique_ptr<SnapshotDelta> Decompress() const;
+	size_t ByteSize() const;
+};
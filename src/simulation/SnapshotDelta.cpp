@@ -2,6 +2,7 @@
 
 #include "common/tpt-minmax.h"
 
+#include <cstring>
 #include <utility>
 
 // * A SnapshotDelta is a bidirectional difference type between Snapshots, defined such
@@ -45,7 +46,7 @@
 //   * FillSingleDiff is the d = B - A operation, while ApplySingleDiff<false> and ApplySingleDiff<true>
 //     are the A = B - d and B = A + d operations. These are self-explanatory.
 //   * This difference type is intended for fields of dynamic size whose data doesn't change often and
-//     doesn't consume too much memory. This covers the Snapshot fields signs and Authors.
+//     doesn't consume too much memory. This covers the Snapshot fields signs, RngState and Authors.
 // * This leaves Snapshot::Particles. This field mirrors Simulation::parts, which is actually also
 //   a field of static size, but since most of the time most of this array is empty, it doesn't make
 //   sense to store all of it in a Snapshot (unlike Air::hv, which can be fairly chaotic (i.e. may have
@@ -68,6 +69,13 @@
 //   structs, even though Snapshot::stickmen is not big enough for us to benefit from this. The
 //   alternative would have been to implement operator ==(const playerst &, const playerst &), which
 //   would have been tedious.
+// * Edits between two Snapshots taken in the history usually touch very few items, so
+//   FillHunkVectorPtr first compares streams in blocks of HunkVectorBlockSize items with memcmp,
+//   and only compares items one by one in blocks that actually differ. Blocks that are identical
+//   byte for byte are also identical as far as operator == is concerned (except for NaNs, which
+//   only ever produced useless Diffs anyway), so this doesn't change the resulting HunkVector.
+
+constexpr size_t HunkVectorBlockSize = 256;
 
 constexpr size_t ParticleUint32Count = sizeof(Particle) / sizeof(uint32_t);
 static_assert(sizeof(Particle) % sizeof(uint32_t) == 0, "fix me");
@@ -148,6 +156,16 @@ void FillHunkVectorPtr(const Item *oldItems, const Item *newItems, SnapshotDelta
 	};
 	while (i < size)
 	{
+		if (i % HunkVectorBlockSize == 0U)
+		{
+			auto blockSize = std::min(HunkVectorBlockSize, size - i);
+			if (!std::memcmp(&oldItems[i], &newItems[i], blockSize * sizeof(Item)))
+			{
+				markDifferent(false);
+				i += blockSize;
+				continue;
+			}
+		}
 		markDifferent(!(oldItems[i] == newItems[i]));
 		i += 1U;
 	}
@@ -218,6 +236,7 @@ std::unique_ptr<SnapshotDelta> SnapshotDelta::FromSnapshots(const Snapshot &oldS
 	FillHunkVector(oldSnap.FanVelocityY   , newSnap.FanVelocityY   , delta.FanVelocityY   );
 	FillHunkVector(oldSnap.WirelessData   , newSnap.WirelessData   , delta.WirelessData   );
 	FillSingleDiff(oldSnap.signs          , newSnap.signs          , delta.signs          );
+	FillSingleDiff(oldSnap.RngState       , newSnap.RngState       , delta.RngState       );
 	FillSingleDiff(oldSnap.Authors        , newSnap.Authors        , delta.Authors        );
 	FillHunkVectorPtr(reinterpret_cast<const uint32_t *>(&oldSnap.PortalParticles[0]), reinterpret_cast<const uint32_t *>(&newSnap.PortalParticles[0]), delta.PortalParticles, newSnap.PortalParticles.size() * ParticleUint32Count);
 	FillHunkVectorPtr(reinterpret_cast<const uint32_t *>(&oldSnap.stickmen[0])       , reinterpret_cast<const uint32_t *>(&newSnap.stickmen[0]       ), delta.stickmen       , newSnap.stickmen       .size() * playerstUint32Count);
@@ -251,6 +270,7 @@ std::unique_ptr<Snapshot> SnapshotDelta::Forward(const Snapshot &oldSnap)
 	ApplyHunkVector<false>(FanVelocityY   , newSnap.FanVelocityY   );
 	ApplyHunkVector<false>(WirelessData   , newSnap.WirelessData   );
 	ApplySingleDiff<false>(signs          , newSnap.signs          );
+	ApplySingleDiff<false>(RngState       , newSnap.RngState       );
 	ApplySingleDiff<false>(Authors        , newSnap.Authors        );
 	ApplyHunkVectorPtr<false>(PortalParticles, reinterpret_cast<uint32_t *>(&newSnap.PortalParticles[0]));
 	ApplyHunkVectorPtr<false>(stickmen       , reinterpret_cast<uint32_t *>(&newSnap.stickmen[0]       ));
@@ -282,6 +302,7 @@ std::unique_ptr<Snapshot> SnapshotDelta::Restore(const Snapshot &newSnap)
 	ApplyHunkVector<true>(FanVelocityY   , oldSnap.FanVelocityY   );
 	ApplyHunkVector<true>(WirelessData   , oldSnap.WirelessData   );
 	ApplySingleDiff<true>(signs          , oldSnap.signs          );
+	ApplySingleDiff<true>(RngState       , oldSnap.RngState       );
 	ApplySingleDiff<true>(Authors        , oldSnap.Authors        );
 	ApplyHunkVectorPtr<true>(PortalParticles, reinterpret_cast<uint32_t *>(&oldSnap.PortalParticles[0]));
 	ApplyHunkVectorPtr<true>(stickmen       , reinterpret_cast<uint32_t *>(&oldSnap.stickmen[0]       ));
@@ -68,6 +68,8 @@ struct SnapshotDelta
 	HunkVector<uint32_t> stickmen;
 	SingleDiff<std::vector<sign>> signs;
 
+	SingleDiff<RNG::State> RngState;
+
 	SingleDiff<Json::Value> Authors;
 
 	static std::unique_ptr<SnapshotDelta> FromSnapshots(const Snapshot &oldSnap, const Snapshot &newSnap);
@@ -72,14 +72,14 @@ static int update(UPDATE_FUNC_ARGS)
 					}
 					else if (rt == PT_WTRV)
 					{
-						if (RNG::Ref().chance(1, 250))
+						if (sim->rng.chance(1, 250))
 						{
 							sim->part_change_type(i, x, y, PT_CAUS);
-							parts[i].life = RNG::Ref().between(25, 74);
+							parts[i].life = sim->rng.between(25, 74);
 							sim->kill_part(ID(r));
 						}
 					}
-					else if (rt != PT_CLNE && rt != PT_PCLN && parts[i].life >= 50 && RNG::Ref().chance(sim->elements[rt].Hardness, 1000))
+					else if (rt != PT_CLNE && rt != PT_PCLN && parts[i].life >= 50 && sim->rng.chance(sim->elements[rt].Hardness, 1000))
 					{
 						if (sim->parts_avg(i, ID(r),PT_GLAS)!= PT_GLAS)//GLAS protects stuff from acid
 						{
@@ -110,8 +110,8 @@ static int update(UPDATE_FUNC_ARGS)
 			}
 	for (trade = 0; trade<2; trade++)
 	{
-		rx = RNG::Ref().between(-2, 2);
-		ry = RNG::Ref().between(-2, 2);
+		rx = sim->rng.between(-2, 2);
+		ry = sim->rng.between(-2, 2);
 		if (BOUNDS_CHECK && (rx || ry))
 		{
 			r = pmap[y+ry][x+rx];
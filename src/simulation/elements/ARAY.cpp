@@ -128,8 +128,8 @@ static int update(UPDATE_FUNC_ARGS)
 							{
 								if (parts[r].tmp != 6)
 								{
-									int Element_FILT_interactWavelengths(Particle* cpart, int origWl);
-									colored = Element_FILT_interactWavelengths(&parts[r], colored);
+									int Element_FILT_interactWavelengths(Simulation *sim, Particle* cpart, int origWl);
+									colored = Element_FILT_interactWavelengths(sim, &parts[r], colored);
 									if (!colored)
 										break;
 								}
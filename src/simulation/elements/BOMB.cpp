@@ -65,6 +65,7 @@ static int update(UPDATE_FUNC_ARGS)
 					int rad = 8, nt;
 					int nxi, nxj;
 					pmap[y][x] = 0;
+					sim->MarkPmapDirty(x, y);
 					for (nxj=-rad; nxj<=rad; nxj++)
 						for (nxi=-rad; nxi<=rad; nxi++)
 							if ((pow((float)nxi,2))/(pow((float)rad,2))+(pow((float)nxj,2))/(pow((float)rad,2))<=1)
@@ -99,8 +100,8 @@ static int update(UPDATE_FUNC_ARGS)
 									parts[nb].tmp = 0;
 									parts[nb].life = 50;
 									parts[nb].temp = MAX_TEMP;
-									parts[nb].vx = float(RNG::Ref().between(-20, 20));
-									parts[nb].vy = float(RNG::Ref().between(-20, 20));
+									parts[nb].vx = float(sim->rng.between(-20, 20));
+									parts[nb].vy = float(sim->rng.between(-20, 20));
 								}
 							}
 					sim->kill_part(i);
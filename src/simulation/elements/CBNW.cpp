@@ -53,7 +53,7 @@ static int update(UPDATE_FUNC_ARGS)
 	int r, rx, ry;
 	if (sim->pv[y/CELL][x/CELL]<=3)
 	{
-		if (sim->pv[y/CELL][x/CELL] <= -0.5 || RNG::Ref().chance(1, 4000))
+		if (sim->pv[y/CELL][x/CELL] <= -0.5 || sim->rng.chance(1, 4000))
 		{
 			sim->part_change_type(i,x,y,PT_CO2);
 			parts[i].ctype = 5;
@@ -63,15 +63,15 @@ static int update(UPDATE_FUNC_ARGS)
 	if (parts[i].tmp2!=20) {
 		parts[i].tmp2 -= (parts[i].tmp2>20)?1:-1;
 	}
-	else if (RNG::Ref().chance(1, 200))
+	else if (sim->rng.chance(1, 200))
 	{
-		parts[i].tmp2 = RNG::Ref().between(0, 39);
+		parts[i].tmp2 = sim->rng.between(0, 39);
 	}
 
 	if(parts[i].tmp>0)
 	{
 		//Explode
-		if(parts[i].tmp==1 && RNG::Ref().chance(3, 4))
+		if(parts[i].tmp==1 && sim->rng.chance(3, 4))
 		{
 			sim->part_change_type(i,x,y,PT_CO2);
 			parts[i].ctype = 5;
@@ -86,12 +86,12 @@ static int update(UPDATE_FUNC_ARGS)
 				r = pmap[y+ry][x+rx];
 				if (!r)
 					continue;
-				if ((sim->elements[TYP(r)].Properties&TYPE_PART) && parts[i].tmp == 0 && RNG::Ref().chance(1, 83))
+				if ((sim->elements[TYP(r)].Properties&TYPE_PART) && parts[i].tmp == 0 && sim->rng.chance(1, 83))
 				{
 					//Start explode
-					parts[i].tmp = RNG::Ref().between(0, 24);
+					parts[i].tmp = sim->rng.between(0, 24);
 				}
-				else if((sim->elements[TYP(r)].Properties&TYPE_SOLID) && TYP(r)!=PT_DMND && TYP(r)!=PT_GLAS && parts[i].tmp == 0 && RNG::Ref().chance(int(2 - sim->pv[y/CELL][x/CELL]), 6667))
+				else if((sim->elements[TYP(r)].Properties&TYPE_SOLID) && TYP(r)!=PT_DMND && TYP(r)!=PT_GLAS && parts[i].tmp == 0 && sim->rng.chance(int(2 - sim->pv[y/CELL][x/CELL]), 6667))
 				{
 					sim->part_change_type(i,x,y,PT_CO2);
 					parts[i].ctype = 5;
@@ -117,7 +117,7 @@ static int update(UPDATE_FUNC_ARGS)
 				}
 				else if (TYP(r)==PT_RBDM||TYP(r)==PT_LRBD)
 				{
-					if ((sim->legacy_enable||parts[i].temp>(273.15f+12.0f)) && RNG::Ref().chance(1, 166))
+					if ((sim->legacy_enable||parts[i].temp>(273.15f+12.0f)) && sim->rng.chance(1, 166))
 					{
 						sim->part_change_type(i,x,y,PT_FIRE);
 						parts[i].life = 4;
@@ -126,7 +126,7 @@ static int update(UPDATE_FUNC_ARGS)
 				}
 				else if (TYP(r)==PT_FIRE && parts[ID(r)].ctype!=PT_WATR){
 					sim->kill_part(ID(r));
-					if (RNG::Ref().chance(1, 50))
+					if (sim->rng.chance(1, 50))
 					{
 						sim->kill_part(i);
 						return 1;
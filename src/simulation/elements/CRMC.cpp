@@ -67,5 +67,5 @@ static int graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	sim->parts[i].tmp2 = RNG::Ref().between(0, 4);
+	sim->parts[i].tmp2 = sim->rng.between(0, 4);
 }
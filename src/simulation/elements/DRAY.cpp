@@ -164,6 +164,7 @@ static int update(UPDATE_FUNC_ARGS)
 								parts[p] = parts[ID(pmap[yCurrent][xCurrent])];
 							parts[p].x = float(xCopyTo);
 							parts[p].y = float(yCopyTo);
+							sim->UpdateSubframeOrder(p);
 						}
 					}
 				}
@@ -57,29 +57,29 @@ static int update(UPDATE_FUNC_ARGS)
 				switch (TYP(r))
 				{
 				case PT_SALT:
-					if (RNG::Ref().chance(1, 50))
+					if (sim->rng.chance(1, 50))
 					{
 						sim->part_change_type(i,x,y,PT_SLTW);
 						// on average, convert 3 DSTW to SLTW before SALT turns into SLTW
-						if (RNG::Ref().chance(1, 3))
+						if (sim->rng.chance(1, 3))
 							sim->part_change_type(ID(r),x+rx,y+ry,PT_SLTW);
 					}
 					break;
 				case PT_SLTW:
-					if (RNG::Ref().chance(1, 2000))
+					if (sim->rng.chance(1, 2000))
 					{
 						sim->part_change_type(i,x,y,PT_SLTW);
 						break;
 					}
 				case PT_WATR:
-					if (RNG::Ref().chance(1, 100))
+					if (sim->rng.chance(1, 100))
 					{
 						sim->part_change_type(i,x,y,PT_WATR);
 					}
 					break;
 				case PT_RBDM:
 				case PT_LRBD:
-					if ((sim->legacy_enable||parts[i].temp>12.0f) && RNG::Ref().chance(1, 100))
+					if ((sim->legacy_enable||parts[i].temp>12.0f) && sim->rng.chance(1, 100))
 					{
 						sim->part_change_type(i,x,y,PT_FIRE);
 						parts[i].life = 4;
@@ -87,7 +87,7 @@ static int update(UPDATE_FUNC_ARGS)
 					break;
 				case PT_FIRE:
 					sim->kill_part(ID(r));
-					if (RNG::Ref().chance(1, 30))
+					if (sim->rng.chance(1, 30))
 					{
 						sim->kill_part(i);
 						return 1;
@@ -83,7 +83,7 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 			else if (parts[i].temp<625)
 			{
 				sim->part_change_type(i,x,y,PT_SMKE);
-				parts[i].life = RNG::Ref().between(250, 269);
+				parts[i].life = sim->rng.between(250, 269);
 			}
 		}
 		break;
@@ -97,34 +97,34 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 				break;
 			}
 
-			if (pres >= 25 && RNG::Ref().chance(1, 12500))
+			if (pres >= 25 && sim->rng.chance(1, 12500))
 			{
 				if (pres <= 50)
 				{
-					if (RNG::Ref().chance(1, 2))
+					if (sim->rng.chance(1, 2))
 						parts[i].ctype = PT_BRMT;
 					else
 						parts[i].ctype = PT_CNCT;
 				}
 				else if (pres <= 75)
 				{
-					if (pres >= 73 || RNG::Ref().chance(1, 8))
+					if (pres >= 73 || sim->rng.chance(1, 8))
 						parts[i].ctype = PT_GOLD;
 					else
 						parts[i].ctype = PT_QRTZ;
 				}
 				else if (pres <= 100 && parts[i].temp >= 5000)
 				{
-					if (RNG::Ref().chance(1, 5)) // 1 in 5 chance IRON to TTAN
+					if (sim->rng.chance(1, 5)) // 1 in 5 chance IRON to TTAN
 						parts[i].ctype = PT_TTAN;
 					else
 						parts[i].ctype = PT_IRON;
 				}
-				else if (parts[i].temp >= 5000 && RNG::Ref().chance(1, 5))
+				else if (parts[i].temp >= 5000 && sim->rng.chance(1, 5))
 				{
-					if (RNG::Ref().chance(1, 5))
+					if (sim->rng.chance(1, 5))
 						parts[i].ctype = PT_URAN;
-					else if (RNG::Ref().chance(1, 5))
+					else if (sim->rng.chance(1, 5))
 						parts[i].ctype = PT_PLUT;
 					else
 						parts[i].ctype = PT_TUNG;
@@ -133,7 +133,7 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 		}
 		else if ((parts[i].ctype == PT_STNE || !parts[i].ctype) && sim->pv[y / CELL][x / CELL] >= 30.0f && (parts[i].temp > 1943.15f || sim->pv[y / CELL][x / CELL] < 120.0f)) // Form ROCK with pressure, if it will stay molten or not immediately break
 		{
-			parts[i].tmp2 = RNG::Ref().between(0, 10); // Provide tmp2 for color noise
+			parts[i].tmp2 = sim->rng.between(0, 10); // Provide tmp2 for color noise
 			parts[i].ctype = PT_ROCK;
 		}
 		break;
@@ -152,7 +152,7 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 				//THRM burning
 				if (rt==PT_THRM && (t==PT_FIRE || t==PT_PLSM || t==PT_LAVA))
 				{
-					if (RNG::Ref().chance(1, 500)) {
+					if (sim->rng.chance(1, 500)) {
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_LAVA);
 						parts[ID(r)].ctype = PT_BMTL;
 						parts[ID(r)].temp = 3500.0f;
@@ -171,20 +171,20 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 				{
 					if ((t==PT_FIRE || t==PT_PLSM))
 					{
-						if (parts[ID(r)].life>100 && RNG::Ref().chance(1, 500))
+						if (parts[ID(r)].life>100 && sim->rng.chance(1, 500))
 						{
 							parts[ID(r)].life = 99;
 						}
 					}
 					else if (t==PT_LAVA)
 					{
-						if (parts[i].ctype == PT_IRON && RNG::Ref().chance(1, 500))
+						if (parts[i].ctype == PT_IRON && sim->rng.chance(1, 500))
 						{
 							parts[i].ctype = PT_METL;
 							sim->kill_part(ID(r));
 							continue;
 						}
-						if ((parts[i].ctype == PT_STNE || parts[i].ctype == PT_NONE) && RNG::Ref().chance(1, 60))
+						if ((parts[i].ctype == PT_STNE || parts[i].ctype == PT_NONE) && sim->rng.chance(1, 60))
 						{
 							parts[i].ctype = PT_SLCN;
 							sim->kill_part(ID(r));
@@ -207,7 +207,7 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 					}
 					else if (rt == PT_O2 && parts[i].ctype == PT_SLCN)
 					{
-						switch (RNG::Ref().between(0, 2))
+						switch (sim->rng.between(0, 2))
 						{
 						case 0:
 							parts[i].ctype = PT_SAND;
@@ -245,7 +245,7 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 						}
 					}
 					else if (parts[i].ctype == PT_ROCK && rt == PT_LAVA && parts[ID(r)].ctype == PT_GOLD && parts[ID(r)].tmp == 0 &&
-						sim->pv[y / CELL][x / CELL] >= 50 && RNG::Ref().chance(1, 10000)) // Produce GOLD veins/clusters
+						sim->pv[y / CELL][x / CELL] >= 50 && sim->rng.chance(1, 10000)) // Produce GOLD veins/clusters
 					{
 						parts[i].ctype = PT_GOLD;
 						if (rx > 1 || rx < -1) // Trend veins vertical
@@ -254,7 +254,7 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 				}
 
 				if ((surround_space || sim->elements[rt].Explosive) &&
-				    sim->elements[rt].Flammable && RNG::Ref().chance(int(sim->elements[rt].Flammable + (sim->pv[(y+ry)/CELL][(x+rx)/CELL] * 10.0f)), 1000) &&
+				    sim->elements[rt].Flammable && sim->rng.chance(int(sim->elements[rt].Flammable + (sim->pv[(y+ry)/CELL][(x+rx)/CELL] * 10.0f)), 1000) &&
 				    //exceptions, t is the thing causing the spark and rt is what's burning
 				    (t != PT_SPRK || (rt != PT_RBDM && rt != PT_LRBD && rt != PT_INSL)) &&
 				    (t != PT_PHOT || rt != PT_INSL) &&
@@ -262,7 +262,7 @@ int Element_FIRE_update(UPDATE_FUNC_ARGS)
 				{
 					sim->part_change_type(ID(r), x+rx, y+ry, PT_FIRE);
 					parts[ID(r)].temp = restrict_flt(sim->elements[PT_FIRE].DefaultProperties.temp + (sim->elements[rt].Flammable/2), MIN_TEMP, MAX_TEMP);
-					parts[ID(r)].life = RNG::Ref().between(180, 259);
+					parts[ID(r)].life = sim->rng.between(180, 259);
 					parts[ID(r)].tmp = parts[ID(r)].ctype = 0;
 					if (sim->elements[rt].Explosive)
 						sim->pv[y/CELL][x/CELL] += 0.25f * CFDS;
@@ -292,7 +292,7 @@ static int updateLegacy(UPDATE_FUNC_ARGS)
 				if (sim->elements[rt].Meltable &&
 				        ((rt!=PT_RBDM && rt!=PT_LRBD) || t!=PT_SPRK)
 				        && ((t!=PT_FIRE&&t!=PT_PLSM) || (rt!=PT_METL && rt!=PT_IRON && rt!=PT_ETRD && rt!=PT_PSCN && rt!=PT_NSCN && rt!=PT_NTCT && rt!=PT_PTCT && rt!=PT_BMTL && rt!=PT_BRMT && rt!=PT_SALT && rt!=PT_INWR))
-				        && RNG::Ref().chance(sim->elements[rt].Meltable*lpv, 1000))
+				        && sim->rng.chance(sim->elements[rt].Meltable*lpv, 1000))
 				{
 					if (t!=PT_LAVA || parts[i].life>0)
 					{
@@ -303,7 +303,7 @@ static int updateLegacy(UPDATE_FUNC_ARGS)
 						else
 							parts[ID(r)].ctype = rt;
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_LAVA);
-						parts[ID(r)].life = RNG::Ref().between(240, 359);
+						parts[ID(r)].life = sim->rng.between(240, 359);
 					}
 					else
 					{
@@ -366,5 +366,5 @@ static int graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	sim->parts[i].life = RNG::Ref().between(120, 169);
+	sim->parts[i].life = sim->rng.between(120, 169);
 }
@@ -66,12 +66,12 @@ static int update(UPDATE_FUNC_ARGS)
 						sim->GetGravityField(x, y, sim->elements[PT_FIRW].Gravity, 1.0f, gx, gy);
 						if (gx*gx+gy*gy < 0.001f)
 						{
-							float angle = RNG::Ref().between(0, 6283) * 0.001f;//(in radians, between 0 and 2*pi)
+							float angle = sim->rng.between(0, 6283) * 0.001f;//(in radians, between 0 and 2*pi)
 							gx += sinf(angle)*sim->elements[PT_FIRW].Gravity*0.5f;
 							gy += cosf(angle)*sim->elements[PT_FIRW].Gravity*0.5f;
 						}
 						parts[i].tmp = 1;
-						parts[i].life = RNG::Ref().between(20, 29);
+						parts[i].life = sim->rng.between(20, 29);
 						multiplier = (parts[i].life+20)*0.2f/sqrtf(gx*gx+gy*gy);
 						parts[i].vx -= gx*multiplier;
 						parts[i].vy -= gy*multiplier;
@@ -89,7 +89,7 @@ static int update(UPDATE_FUNC_ARGS)
 	else //if (parts[i].tmp>=2)
 	{
 		float angle, magnitude;
-		int caddress = RNG::Ref().between(0, 199) * 3;
+		int caddress = sim->rng.between(0, 199) * 3;
 		int n;
 		unsigned col = (((firw_data[caddress]))<<16) | (((firw_data[caddress+1]))<<8) | ((firw_data[caddress+2]));
 		for (n=0; n<40; n++)
@@ -97,14 +97,14 @@ static int update(UPDATE_FUNC_ARGS)
 			np = sim->create_part(-3, x, y, PT_EMBR);
 			if (np>-1)
 			{
-				magnitude = RNG::Ref().between(40, 99) * 0.05f;
-				angle = RNG::Ref().between(0, 6283) * 0.001f;//(in radians, between 0 and 2*pi)
+				magnitude = sim->rng.between(40, 99) * 0.05f;
+				angle = sim->rng.between(0, 6283) * 0.001f;//(in radians, between 0 and 2*pi)
 				parts[np].vx = parts[i].vx*0.5f + cosf(angle)*magnitude;
 				parts[np].vy = parts[i].vy*0.5f + sinf(angle)*magnitude;
 				parts[np].ctype = col;
 				parts[np].tmp = 1;
-				parts[np].life = RNG::Ref().between(70, 109);
-				parts[np].temp = float(RNG::Ref().between(5750, 6249));
+				parts[np].life = sim->rng.between(70, 109);
+				parts[np].temp = float(sim->rng.between(5750, 6249));
 				parts[np].dcolour = parts[i].dcolour;
 			}
 		}
@@ -58,12 +58,12 @@ static int update(UPDATE_FUNC_ARGS)
 				r = pmap[y+ry][x+rx];
 				if (!r)
 					continue;
-				if (TYP(r)==PT_WATR && RNG::Ref().chance(1, 14))
+				if (TYP(r)==PT_WATR && sim->rng.chance(1, 14))
 				{
 					sim->part_change_type(ID(r),x+rx,y+ry,PT_FRZW);
 				}
 			}
-	if ((parts[i].life==0 && RNG::Ref().chance(1, 192)) || RNG::Ref().chance(100-parts[i].life, 50000))
+	if ((parts[i].life==0 && sim->rng.chance(1, 192)) || sim->rng.chance(100-parts[i].life, 50000))
 	{
 		sim->part_change_type(i,x,y,PT_ICEI);
 		parts[i].ctype=PT_FRZW;
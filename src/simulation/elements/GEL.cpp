@@ -72,31 +72,31 @@ static int update(UPDATE_FUNC_ARGS)
 				case PT_WATR:
 				case PT_DSTW:
 				case PT_FRZW:
-					if (parts[i].tmp<100 && RNG::Ref().chance(500, absorbChanceDenom))
+					if (parts[i].tmp<100 && sim->rng.chance(500, absorbChanceDenom))
 					{
 						parts[i].tmp++;
 						sim->kill_part(ID(r));
 					}
 					break;
 				case PT_PSTE:
-					if (parts[i].tmp<100 && RNG::Ref().chance(20, absorbChanceDenom))
+					if (parts[i].tmp<100 && sim->rng.chance(20, absorbChanceDenom))
 					{
 						parts[i].tmp++;
 						sim->create_part(ID(r), x+rx, y+ry, PT_CLST);
 					}
 					break;
 				case PT_SLTW:
-					if (parts[i].tmp<100 && RNG::Ref().chance(50, absorbChanceDenom))
+					if (parts[i].tmp<100 && sim->rng.chance(50, absorbChanceDenom))
 					{
 						parts[i].tmp++;
-						if (RNG::Ref().chance(3, 4))
+						if (sim->rng.chance(3, 4))
 							sim->kill_part(ID(r));
 						else
 							sim->part_change_type(ID(r), x+rx, y+ry, PT_SALT);
 					}
 					break;
 				case PT_CBNW:
-					if (parts[i].tmp < 100 && RNG::Ref().chance(100, absorbChanceDenom))
+					if (parts[i].tmp < 100 && sim->rng.chance(100, absorbChanceDenom))
 					{
 						parts[i].tmp++;
 						sim->part_change_type(ID(r), x+rx, y+ry, PT_CO2);
@@ -50,7 +50,7 @@ void Element::Element_GRAV()
 
 static int update(UPDATE_FUNC_ARGS)
 {
-	if (parts[i].vx*parts[i].vx + parts[i].vy*parts[i].vy >= 0.1f && RNG::Ref().chance(1, 512))
+	if (parts[i].vx*parts[i].vx + parts[i].vy*parts[i].vy >= 0.1f && sim->rng.chance(1, 512))
 	{
 		if (!parts[i].life)
 			parts[i].life = 48;
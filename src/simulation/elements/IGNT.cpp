@@ -68,20 +68,20 @@ static int update(UPDATE_FUNC_ARGS)
 	}
 	else if(parts[i].life > 0)
 	{
-		if (RNG::Ref().chance(2, 3))
+		if (sim->rng.chance(2, 3))
 		{
-			int nb = sim->create_part(-1, x + RNG::Ref().between(-1, 1), y + RNG::Ref().between(-1, 1), PT_EMBR);
+			int nb = sim->create_part(-1, x + sim->rng.between(-1, 1), y + sim->rng.between(-1, 1), PT_EMBR);
 			if (nb!=-1) {
 				parts[nb].tmp = 0;
 				parts[nb].life = 30;
-				parts[nb].vx = float(RNG::Ref().between(-10, 10));
-				parts[nb].vy = float(RNG::Ref().between(-10, 10));
+				parts[nb].vx = float(sim->rng.between(-10, 10));
+				parts[nb].vy = float(sim->rng.between(-10, 10));
 				parts[nb].temp = restrict_flt(parts[i].temp-273.15f+400.0f, MIN_TEMP, MAX_TEMP);
 			}
 		}
 		else
 		{
-			sim->create_part(-1, x + RNG::Ref().between(-1, 1), y + RNG::Ref().between(-1, 1), PT_FIRE);
+			sim->create_part(-1, x + sim->rng.between(-1, 1), y + sim->rng.between(-1, 1), PT_FIRE);
 		}
 		parts[i].life--;
 	}
@@ -58,19 +58,19 @@ static int update(UPDATE_FUNC_ARGS)
 				switch TYP(r)
 				{
 				case PT_SALT:
-					if (RNG::Ref().chance(1, 47))
+					if (sim->rng.chance(1, 47))
 						goto succ;
 					break;
 				case PT_SLTW:
-					if (RNG::Ref().chance(1, 67))
+					if (sim->rng.chance(1, 67))
 						goto succ;
 					break;
 				case PT_WATR:
-					if (RNG::Ref().chance(1, 1200))
+					if (sim->rng.chance(1, 1200))
 						goto succ;
 					break;
 				case PT_O2:
-					if (RNG::Ref().chance(1, 250))
+					if (sim->rng.chance(1, 250))
 						goto succ;
 					break;
 				case PT_LO2:
@@ -82,6 +82,6 @@ static int update(UPDATE_FUNC_ARGS)
 	return 0;
 succ:
 	sim->part_change_type(i,x,y,PT_BMTL);
-	parts[i].tmp = RNG::Ref().between(20, 29);
+	parts[i].tmp = sim->rng.between(20, 29);
 	return 0;
 }
@@ -52,7 +52,7 @@ static int update(UPDATE_FUNC_ARGS)
 	if (parts[i].temp > 5273.15 && sim->pv[y/CELL][x/CELL] > 100.0f)
 	{
 		parts[i].tmp |= 0x1;
-		if (RNG::Ref().chance(1, 5))
+		if (sim->rng.chance(1, 5))
 		{
 			int j;
 			float temp = parts[i].temp;
@@ -61,7 +61,7 @@ static int update(UPDATE_FUNC_ARGS)
 			j = sim->create_part(-3,x,y,PT_NEUT);
 			if (j != -1)
 				parts[j].temp = temp;
-			if (RNG::Ref().chance(1, 25))
+			if (sim->rng.chance(1, 25))
 			{
 				j = sim->create_part(-3,x,y,PT_ELEC);
 				if (j != -1)
@@ -74,7 +74,7 @@ static int update(UPDATE_FUNC_ARGS)
 				parts[j].temp = temp;
 				parts[j].tmp = 0x1;
 			}
-			int rx = x + RNG::Ref().between(-1, 1), ry = y + RNG::Ref().between(-1, 1), rt = TYP(pmap[ry][rx]);
+			int rx = x + sim->rng.between(-1, 1), ry = y + sim->rng.between(-1, 1), rt = TYP(pmap[ry][rx]);
 			if (sim->can_move[PT_PLSM][rt] || rt == PT_NBLE)
 			{
 				j = sim->create_part(-3,rx,ry,PT_PLSM);
@@ -84,7 +84,7 @@ static int update(UPDATE_FUNC_ARGS)
 					parts[j].tmp |= 4;
 				}
 			}
-			parts[i].temp = temp + 1750 + RNG::Ref().between(0, 499);
+			parts[i].temp = temp + 1750 + sim->rng.between(0, 499);
 			sim->pv[y/CELL][x/CELL] += 50;
 		}
 	}
@@ -64,7 +64,7 @@ static int update(UPDATE_FUNC_ARGS)
 				switch (TYP(r))
 				{
 				case PT_WATR:
-					if (RNG::Ref().chance(3, 20))
+					if (sim->rng.chance(3, 20))
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_DSTW);
 				case PT_ICEI:
 				case PT_SNOW:
@@ -72,11 +72,11 @@ static int update(UPDATE_FUNC_ARGS)
 					parts[i].vy *= 0.995f;
 					break;
 				case PT_PLUT:
-					if (RNG::Ref().chance(pressureFactor, 1000))
+					if (sim->rng.chance(pressureFactor, 1000))
 					{
-						if (RNG::Ref().chance(1, 3))
+						if (sim->rng.chance(1, 3))
 						{
-							sim->create_part(ID(r), x+rx, y+ry, RNG::Ref().chance(2, 3) ? PT_LAVA : PT_URAN);
+							sim->create_part(ID(r), x+rx, y+ry, sim->rng.chance(2, 3) ? PT_LAVA : PT_URAN);
 							parts[ID(r)].temp = MAX_TEMP;
 							if (parts[ID(r)].type==PT_LAVA) {
 								parts[ID(r)].tmp = 100;
@@ -95,7 +95,7 @@ static int update(UPDATE_FUNC_ARGS)
 					break;
 #ifdef SDEUT
 				case PT_DEUT:
-					if (RNG::Ref().chance(pressureFactor + 1 + (parts[ID(r)].life/100), 1000))
+					if (sim->rng.chance(pressureFactor + 1 + (parts[ID(r)].life/100), 1000))
 					{
 						DeutExplosion(sim, parts[ID(r)].life, x+rx, y+ry, restrict_flt(parts[ID(r)].temp + parts[ID(r)].life*500.0f, MIN_TEMP, MAX_TEMP), PT_NEUT);
 						sim->kill_part(ID(r));
@@ -103,7 +103,7 @@ static int update(UPDATE_FUNC_ARGS)
 					break;
 #else
 				case PT_DEUT:
-					if (RNG::Ref().chance(pressureFactor+1, 1000))
+					if (sim->rng.chance(pressureFactor+1, 1000))
 					{
 						create_part(ID(r), x+rx, y+ry, PT_NEUT);
 						parts[ID(r)].vx = 0.25f*parts[ID(r)].vx + parts[i].vx;
@@ -116,66 +116,66 @@ static int update(UPDATE_FUNC_ARGS)
 					break;
 #endif
 				case PT_GUNP:
-					if (RNG::Ref().chance(3, 200))
+					if (sim->rng.chance(3, 200))
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_DUST);
 					break;
 				case PT_DYST:
-					if (RNG::Ref().chance(3, 200))
+					if (sim->rng.chance(3, 200))
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_YEST);
 					break;
 				case PT_YEST:
 					sim->part_change_type(ID(r),x+rx,y+ry,PT_DYST);
 					break;
 				case PT_PLEX:
-					if (RNG::Ref().chance(3, 200))
+					if (sim->rng.chance(3, 200))
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_GOO);
 					break;
 				case PT_NITR:
-					if (RNG::Ref().chance(3, 200))
+					if (sim->rng.chance(3, 200))
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_DESL);
 					break;
 				case PT_PLNT:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 						sim->create_part(ID(r), x+rx, y+ry, PT_WOOD);
 					break;
 				case PT_DESL:
 				case PT_OIL:
-					if (RNG::Ref().chance(3, 200))
+					if (sim->rng.chance(3, 200))
 						sim->part_change_type(ID(r),x+rx,y+ry,PT_GAS);
 					break;
 				case PT_COAL:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 						sim->create_part(ID(r), x+rx, y+ry, PT_WOOD);
 					break;
 				case PT_BCOL:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 						sim->create_part(ID(r), x+rx, y+ry, PT_SAWD);
 					break;
 				case PT_DUST:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 						sim->part_change_type(ID(r), x+rx, y+ry, PT_FWRK);
 					break;
 				case PT_FWRK:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 						parts[ID(r)].ctype = PT_DUST;
 					break;
 				case PT_ACID:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 						sim->create_part(ID(r), x+rx, y+ry, PT_ISOZ);
 					break;
 				case PT_TTAN:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 					{
 						sim->kill_part(i);
 						return 1;
 					}
 					break;
 				case PT_EXOT:
-					if (RNG::Ref().chance(1, 20))
+					if (sim->rng.chance(1, 20))
 						parts[ID(r)].life = 1500;
 					break;
 				case PT_RFRG:
-					if (RNG::Ref().chance(1, 2))
+					if (sim->rng.chance(1, 2))
 						sim->create_part(ID(r), x+rx, y+ry, PT_GAS);
 					else
 						sim->create_part(ID(r), x+rx, y+ry, PT_CAUS);
@@ -200,9 +200,9 @@ static int graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	float r = RNG::Ref().between(128, 255) / 127.0f;
-	float a = RNG::Ref().between(0, 359) * 3.14159f / 180.0f;
-	sim->parts[i].life = RNG::Ref().between(480, 959);
+	float r = sim->rng.between(128, 255) / 127.0f;
+	float a = sim->rng.between(0, 359) * 3.14159f / 180.0f;
+	sim->parts[i].life = sim->rng.between(480, 959);
 	sim->parts[i].vx = r * cosf(a);
 	sim->parts[i].vy = r * sinf(a);
 }
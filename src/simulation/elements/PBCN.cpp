@@ -55,7 +55,7 @@ static int update(UPDATE_FUNC_ARGS)
 {
 	int r, rx, ry, rt;
 	if (!parts[i].tmp2 && sim->pv[y/CELL][x/CELL]>4.0f)
-		parts[i].tmp2 = RNG::Ref().between(80, 119);
+		parts[i].tmp2 = sim->rng.between(80, 119);
 	if (parts[i].tmp2)
 	{
 		parts[i].vx += ADVECTION*sim->vx[y/CELL][x/CELL];
@@ -135,9 +135,9 @@ static int update(UPDATE_FUNC_ARGS)
 					for (ry=-1; ry<2; ry++)
 						sim->create_part(-1, x+rx, y+ry, PT_LIFE, parts[i].tmp);
 
-			else if (parts[i].ctype!=PT_LIGH || RNG::Ref().chance(1, 30))
+			else if (parts[i].ctype!=PT_LIGH || sim->rng.chance(1, 30))
 			{
-				int np = sim->create_part(-1, x + RNG::Ref().between(-1, 1), y + RNG::Ref().between(-1, 1), TYP(parts[i].ctype));
+				int np = sim->create_part(-1, x + sim->rng.between(-1, 1), y + sim->rng.between(-1, 1), TYP(parts[i].ctype));
 				if (np>-1)
 				{
 					if (parts[i].ctype==PT_LAVA && parts[i].tmp>0 && parts[i].tmp<PT_NUM && sim->elements[parts[i].tmp].HighTemperatureTransition==PT_LAVA)
@@ -63,7 +63,7 @@ static int update(UPDATE_FUNC_ARGS)
 		return 1;
 	}
 	if (parts[i].temp > 506)
-		if (RNG::Ref().chance(1, 10))
+		if (sim->rng.chance(1, 10))
 			Element_FIRE_update(UPDATE_FUNC_SUBCALL_ARGS);
 	for (rx=-1; rx<2; rx++)
 		for (ry=-1; ry<2; ry++)
@@ -73,16 +73,16 @@ static int update(UPDATE_FUNC_ARGS)
 					continue;
 				if (TYP(r)==PT_ISOZ || TYP(r)==PT_ISZS)
 				{
-					if (RNG::Ref().chance(1, 400))
+					if (sim->rng.chance(1, 400))
 					{
 						parts[i].vx *= 0.90f;
 						parts[i].vy *= 0.90f;
 						sim->create_part(ID(r), x+rx, y+ry, PT_PHOT);
-						rrr = RNG::Ref().between(0, 359) * 3.14159f / 180.0f;
+						rrr = sim->rng.between(0, 359) * 3.14159f / 180.0f;
 						if (TYP(r) == PT_ISOZ)
-							rr = RNG::Ref().between(128, 255) / 127.0f;
+							rr = sim->rng.between(128, 255) / 127.0f;
 						else
-							rr = RNG::Ref().between(128, 355) / 127.0f;
+							rr = sim->rng.between(128, 355) / 127.0f;
 						parts[ID(r)].vx = rr*cosf(rrr);
 						parts[ID(r)].vy = rr*sinf(rrr);
 						sim->pv[y/CELL][x/CELL] -= 15.0f * CFDS;
@@ -90,17 +90,17 @@ static int update(UPDATE_FUNC_ARGS)
 				}
 				else if((TYP(r) == PT_QRTZ || TYP(r) == PT_PQRT) && !ry && !rx)//if on QRTZ
 				{
-					float a = RNG::Ref().between(0, 359) * 3.14159f / 180.0f;
+					float a = sim->rng.between(0, 359) * 3.14159f / 180.0f;
 					parts[i].vx = 3.0f*cosf(a);
 					parts[i].vy = 3.0f*sinf(a);
 					if(parts[i].ctype == 0x3FFFFFFF)
-						parts[i].ctype = 0x1F << RNG::Ref().between(0, 25);
+						parts[i].ctype = 0x1F << sim->rng.between(0, 25);
 					if (parts[i].life)
 						parts[i].life++; //Delay death
 				}
 				else if(TYP(r) == PT_BGLA && !ry && !rx)//if on BGLA
 				{
-					float a = RNG::Ref().between(-50, 50) * 0.001f;
+					float a = sim->rng.between(-50, 50) * 0.001f;
 					float rx = cosf(a), ry = sinf(a), vx, vy;
 					vx = rx * parts[i].vx + ry * parts[i].vy;
 					vy = rx * parts[i].vy - ry * parts[i].vx;
@@ -109,8 +109,8 @@ static int update(UPDATE_FUNC_ARGS)
 				}
 				else if (TYP(r) == PT_FILT && parts[ID(r)].tmp==9)
 				{
-					parts[i].vx += ((float)RNG::Ref().between(-500, 500))/1000.0f;
-					parts[i].vy += ((float)RNG::Ref().between(-500, 500))/1000.0f;
+					parts[i].vx += ((float)sim->rng.between(-500, 500))/1000.0f;
+					parts[i].vy += ((float)sim->rng.between(-500, 500))/1000.0f;
 				}
 			}
 	return 0;
@@ -147,10 +147,10 @@ static int graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	float a = RNG::Ref().between(0, 7) * 0.78540f;
+	float a = sim->rng.between(0, 7) * 0.78540f;
 	sim->parts[i].vx = 3.0f * cosf(a);
 	sim->parts[i].vy = 3.0f * sinf(a);
-	int Element_FILT_interactWavelengths(Particle* cpart, int origWl);
+	int Element_FILT_interactWavelengths(Simulation *sim, Particle* cpart, int origWl);
 	if (TYP(sim->pmap[y][x]) == PT_FILT)
-		sim->parts[i].ctype = Element_FILT_interactWavelengths(&sim->parts[ID(sim->pmap[y][x])], sim->parts[i].ctype);
+		sim->parts[i].ctype = Element_FILT_interactWavelengths(sim, &sim->parts[ID(sim->pmap[y][x])], sim->parts[i].ctype);
 }
@@ -70,5 +70,5 @@ static int graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	sim->parts[i].life = RNG::Ref().between(50, 199);
+	sim->parts[i].life = sim->rng.between(50, 199);
 }
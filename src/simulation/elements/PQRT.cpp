@@ -51,5 +51,5 @@ void Element::Element_PQRT()
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	sim->parts[i].tmp2 = RNG::Ref().between(0, 10);
+	sim->parts[i].tmp2 = sim->rng.between(0, 10);
 }
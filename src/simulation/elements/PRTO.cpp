@@ -74,7 +74,7 @@ static int update(UPDATE_FUNC_ARGS)
 					fe = 1;
 					for ( nnx =0 ; nnx<80; nnx++)
 					{
-						int randomness = (count + RNG::Ref().between(-1, 1) + 4) % 8;//add -1,0,or 1 to count
+						int randomness = (count + sim->rng.between(-1, 1) + 4) % 8;//add -1,0,or 1 to count
 						if (sim->portalp[parts[i].tmp][randomness][nnx].type==PT_SPRK)// TODO: make it look better, spark creation
 						{
 							sim->create_part(-1,x+1,y,PT_SPRK);
@@ -132,6 +132,7 @@ static int update(UPDATE_FUNC_ARGS)
 								parts[np] = sim->portalp[parts[i].tmp][randomness][nnx];
 							parts[np].x = float(x+rx);
 							parts[np].y = float(y+ry);
+							sim->UpdateSubframeOrder(np);
 							memset(&sim->portalp[parts[i].tmp][randomness][nnx], 0, sizeof(Particle));
 							break;
 						}
@@ -142,15 +143,15 @@ static int update(UPDATE_FUNC_ARGS)
 	if (fe) {
 		int orbd[4] = {0, 0, 0, 0};	//Orbital distances
 		int orbl[4] = {0, 0, 0, 0};	//Orbital locations
-		if (!sim->parts[i].life) parts[i].life = RNG::Ref().gen();
-		if (!sim->parts[i].ctype) parts[i].ctype = RNG::Ref().gen();
+		if (!sim->parts[i].life) parts[i].life = sim->rng.gen();
+		if (!sim->parts[i].ctype) parts[i].ctype = sim->rng.gen();
 		sim->orbitalparts_get(parts[i].life, parts[i].ctype, orbd, orbl);
 		for (r = 0; r < 4; r++) {
 			if (orbd[r]<254) {
 				orbd[r] += 16;
 				if (orbd[r]>254) {
 					orbd[r] = 0;
-					orbl[r] = RNG::Ref().between(0, 254);
+					orbl[r] = sim->rng.between(0, 254);
 				}
 				else
 				{
@@ -161,7 +162,7 @@ static int update(UPDATE_FUNC_ARGS)
 				//orbl[r] = orbl[r]%255;
 			} else {
 				orbd[r] = 0;
-				orbl[r] = RNG::Ref().between(0, 254);
+				orbl[r] = sim->rng.between(0, 254);
 			}
 		}
 		sim->orbitalparts_set(&parts[i].life, &parts[i].ctype, orbd, orbl);
@@ -308,6 +308,9 @@ static int MoveStack(Simulation * sim, int stackX, int stackY, int directionX, i
 				sim->parts[jP].x = float(destX);
 				sim->parts[jP].y = float(destY);
 				sim->pmap[destY][destX] = PMAP(jP, sim->parts[jP].type);
+				sim->MarkPmapDirty(srcX, srcY);
+				sim->MarkPmapDirty(destX, destY);
+				sim->UpdateSubframeOrder(jP);
 			}
 			return amount;
 		}
@@ -331,6 +334,9 @@ static int MoveStack(Simulation * sim, int stackX, int stackY, int directionX, i
 				sim->parts[jP].x = float(destX);
 				sim->parts[jP].y = float(destY);
 				sim->pmap[destY][destX] = PMAP(jP, sim->parts[jP].type);
+				sim->MarkPmapDirty(srcX, srcY);
+				sim->MarkPmapDirty(destX, destY);
+				sim->UpdateSubframeOrder(jP);
 			}
 			return possibleMovement;
 		}
@@ -84,7 +84,7 @@ static void hygn_reactions(int hygn1_id, UPDATE_FUNC_ARGS)
 				}
 
 				// Cold fusion: 2 hydrogen > 500 C has a chance to fuse
-				if (rt == PT_H2 && RNG::Ref().chance(1, 1000) && parts[ID(r)].temp > 500.0f + 273.15f && parts[hygn1_id].temp > 500.0f + 273.15f)
+				if (rt == PT_H2 && sim->rng.chance(1, 1000) && parts[ID(r)].temp > 500.0f + 273.15f && parts[hygn1_id].temp > 500.0f + 273.15f)
 				{
 					sim->part_change_type(ID(r), x + rx, y + ry, PT_NBLE);
 					sim->part_change_type(hygn1_id, (int)(parts[hygn1_id].x + 0.5f), (int)(parts[hygn1_id].y + 0.5f), PT_NEUT);
@@ -100,7 +100,7 @@ static void hygn_reactions(int hygn1_id, UPDATE_FUNC_ARGS)
 						parts[j].temp = parts[ID(r)].temp;
 						parts[j].tmp = 0x1;
 					}
-					if (RNG::Ref().chance(1, 10))
+					if (sim->rng.chance(1, 10))
 					{
 						int j = sim->create_part(-3, x + rx, y + ry, PT_ELEC);
 						if (j > -1)
@@ -183,7 +183,7 @@ static int update(UPDATE_FUNC_ARGS)
 				float prob = std::min(1.0f, parts[i].temp / (273.15f + 1500.0f));
 				prob *= prob;
 
-				if (RNG::Ref().uniform01() <= prob)
+				if (sim->rng.uniform01() <= prob)
 				{
 					switch (rt)
 					{
@@ -231,6 +231,6 @@ static int graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	if (RNG::Ref().chance(1, 15))
+	if (sim->rng.chance(1, 15))
 		sim->parts[i].tmp = 1;
 }
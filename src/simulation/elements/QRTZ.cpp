@@ -74,7 +74,7 @@ int Element_QRTZ_update(UPDATE_FUNC_ARGS)
 					r = pmap[y+ry][x+rx];
 					if (!r)
 						continue;
-					else if (TYP(r)==PT_SLTW && RNG::Ref().chance(1, 500))
+					else if (TYP(r)==PT_SLTW && sim->rng.chance(1, 500))
 					{
 						sim->kill_part(ID(r));
 						parts[i].tmp++;
@@ -87,7 +87,7 @@ int Element_QRTZ_update(UPDATE_FUNC_ARGS)
 		int rnd, sry, srx;
 		for (trade = 0; trade < 9; trade++)
 		{
-			rnd = RNG::Ref().gen() % 0x3FF;
+			rnd = sim->rng.gen() % 0x3FF;
 			rx = (rnd%5)-2;
 			srx = (rnd%3)-1;
 			rnd >>= 3;
@@ -110,11 +110,11 @@ int Element_QRTZ_update(UPDATE_FUNC_ARGS)
 								// If PQRT is stationary and has started growing particles of QRTZ, the PQRT is basically part of a new QRTZ crystal. So turn it back into QRTZ so that it behaves more like part of the crystal.
 								sim->part_change_type(i,x,y,PT_QRTZ);
 							}
-							if (RNG::Ref().chance(1, 2))
+							if (sim->rng.chance(1, 2))
 							{
 								parts[np].tmp=-1;//dead qrtz
 							}
-							else if (!parts[i].tmp && RNG::Ref().chance(1, 15))
+							else if (!parts[i].tmp && sim->rng.chance(1, 15))
 							{
 								parts[i].tmp=-1;
 							}
@@ -160,6 +160,6 @@ int Element_QRTZ_graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	sim->parts[i].tmp2 = RNG::Ref().between(0, 10);
+	sim->parts[i].tmp2 = sim->rng.between(0, 10);
 	sim->parts[i].tmp3 = int(sim->pv[y/CELL][x/CELL] * 64);
 }
@@ -52,8 +52,8 @@ static int update(UPDATE_FUNC_ARGS)
 	int r, rx, ry, ri;
 	for(ri = 0; ri <= 10; ri++)
 	{
-		rx = RNG::Ref().between(-10, 10);
-		ry = RNG::Ref().between(-10, 10);
+		rx = sim->rng.between(-10, 10);
+		ry = sim->rng.between(-10, 10);
 		if (x+rx >= 0 && x+rx < XRES && y+ry >= 0 && y+ry < YRES && (rx || ry))
 		{
 			r = pmap[y+ry][x+rx];
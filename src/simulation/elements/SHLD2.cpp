@@ -61,7 +61,7 @@ static int update(UPDATE_FUNC_ARGS)
 				}
 				else if (TYP(r)==PT_SPRK&&parts[i].life==0)
 				{
-					if (RNG::Ref().chance(1, 8))
+					if (sim->rng.chance(1, 8))
 					{
 						sim->part_change_type(i,x,y,PT_SHLD3);
 						parts[i].life = 7;
@@ -77,7 +77,7 @@ static int update(UPDATE_FUNC_ARGS)
 							}
 						}
 				}
-				else if (TYP(r) == PT_SHLD4 && RNG::Ref().chance(2, 5))
+				else if (TYP(r) == PT_SHLD4 && sim->rng.chance(2, 5))
 				{
 					sim->part_change_type(i,x,y,PT_SHLD3);
 					parts[i].life = 7;
@@ -55,7 +55,7 @@ static int update(UPDATE_FUNC_ARGS)
 				r = pmap[y+ry][x+rx];
 				if (!r)
 				{
-					if (RNG::Ref().chance(1, 2500))
+					if (sim->rng.chance(1, 2500))
 					{
 						np = sim->create_part(-1,x+rx,y+ry,PT_SHLD1);
 						if (np<0) continue;
@@ -71,7 +71,7 @@ static int update(UPDATE_FUNC_ARGS)
 				}
 				else if (TYP(r)==PT_SPRK&&parts[i].life==0)
 				{
-					if (RNG::Ref().chance(3, 500))
+					if (sim->rng.chance(3, 500))
 					{
 						sim->part_change_type(i,x,y,PT_SHLD4);
 						parts[i].life = 7;
@@ -70,9 +70,9 @@ static int update(UPDATE_FUNC_ARGS)
 				else if (rt!=PT_CLNE&&rt!=PT_THDR&&rt!=PT_SPRK&&rt!=PT_DMND&&rt!=PT_FIRE)
 				{
 					sim->pv[y/CELL][x/CELL] += 100.0f;
-					if (sim->legacy_enable && RNG::Ref().chance(1, 200))
+					if (sim->legacy_enable && sim->rng.chance(1, 200))
 					{
-						parts[i].life = RNG::Ref().between(120, 169);
+						parts[i].life = sim->rng.between(120, 169);
 						sim->part_change_type(i,x,y,PT_FIRE);
 					}
 					else
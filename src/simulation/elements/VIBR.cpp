@@ -83,7 +83,7 @@ int Element_VIBR_update(UPDATE_FUNC_ARGS)
 	else //if it is exploding
 	{
 		//Release sparks before explode
-		rndstore = RNG::Ref().gen();
+		rndstore = sim->rng.gen();
 		if (parts[i].life < 300)
 		{
 			rx = rndstore%3-1;
@@ -117,7 +117,7 @@ int Element_VIBR_update(UPDATE_FUNC_ARGS)
 		{
 			if (!parts[i].tmp2)
 			{
-				rndstore = RNG::Ref().gen();
+				rndstore = sim->rng.gen();
 				int index = sim->create_part(-3,x+((rndstore>>4)&3)-1,y+((rndstore>>6)&3)-1,PT_ELEC);
 				if (index != -1)
 					parts[index].temp = 7000;
@@ -125,7 +125,7 @@ int Element_VIBR_update(UPDATE_FUNC_ARGS)
 				if (index != -1)
 					parts[index].temp = 7000;
 				int rx = ((rndstore>>12)&3)-1;
-				rndstore = RNG::Ref().gen();
+				rndstore = sim->rng.gen();
 				index = sim->create_part(-1,x+rx-1,y+rndstore%3-1,PT_BREC);
 				if (index != -1)
 					parts[index].temp = 7000;
@@ -159,7 +159,7 @@ int Element_VIBR_update(UPDATE_FUNC_ARGS)
 					{
 						if (!parts[ID(r)].life)
 							parts[ID(r)].tmp += 45;
-						else if (parts[i].tmp2 && parts[i].life > 75 && RNG::Ref().chance(1, 2))
+						else if (parts[i].tmp2 && parts[i].life > 75 && sim->rng.chance(1, 2))
 						{
 							parts[ID(r)].tmp2 = 1;
 							parts[i].tmp = 0;
@@ -174,7 +174,7 @@ int Element_VIBR_update(UPDATE_FUNC_ARGS)
 				else
 				{
 					//Melts into EXOT
-					if (TYP(r) == PT_EXOT && RNG::Ref().chance(1, 25))
+					if (TYP(r) == PT_EXOT && sim->rng.chance(1, 25))
 					{
 						sim->part_change_type(i, x, y, PT_EXOT);
 						return 1;
@@ -190,7 +190,7 @@ int Element_VIBR_update(UPDATE_FUNC_ARGS)
 	for (trade = 0; trade < 9; trade++)
 	{
 		if (!(trade%2))
-			rndstore = RNG::Ref().gen();
+			rndstore = sim->rng.gen();
 		rx = rndstore%7-3;
 		rndstore >>= 3;
 		ry = rndstore%7-3;
@@ -55,13 +55,13 @@ static int update(UPDATE_FUNC_ARGS)
 	{
 		parts[i].temp = 10000;
 		sim->pv[y/CELL][x/CELL] += (parts[i].tmp2 / 5000) * CFDS;
-		if (RNG::Ref().chance(1, 50))
+		if (sim->rng.chance(1, 50))
 			sim->create_part(-3, x, y, PT_ELEC);
 	}
 	for (int trade = 0; trade < 5; trade ++)
 	{
-		int rx = RNG::Ref().between(-1, 1);
-		int ry = RNG::Ref().between(-1, 1);
+		int rx = sim->rng.between(-1, 1);
+		int ry = sim->rng.between(-1, 1);
 		if (BOUNDS_CHECK && (rx || ry))
 		{
 			int r = pmap[y + ry][x + rx];
@@ -73,11 +73,15 @@ static int update(UPDATE_FUNC_ARGS)
 				parts[i].y = parts[ID(r)].y;
 				parts[ID(r)].x = float(x);
 				parts[ID(r)].y = float(y);
-				parts[ID(r)].vx = RNG::Ref().between(-2, 1) + 0.5f;
-				parts[ID(r)].vy = float(RNG::Ref().between(-2, 1));
+				parts[ID(r)].vx = sim->rng.between(-2, 1) + 0.5f;
+				parts[ID(r)].vy = float(sim->rng.between(-2, 1));
 				parts[i].life += 4;
 				pmap[y][x] = r;
 				pmap[y + ry][x + rx] = PMAP(i, parts[i].type);
+				sim->MarkPmapDirty(x, y);
+				sim->MarkPmapDirty(x + rx, y + ry);
+				sim->UpdateSubframeOrder(i);
+				sim->UpdateSubframeOrder(ID(r));
 				trade = 5;
 			}
 		}
@@ -94,5 +98,5 @@ static int graphics(GRAPHICS_FUNC_ARGS)
 
 static void create(ELEMENT_CREATE_FUNC_ARGS)
 {
-	sim->parts[i].life = RNG::Ref().between(70, 164);
+	sim->parts[i].life = sim->rng.between(70, 164);
 }
@@ -20,7 +20,7 @@ static int perform(Simulation * sim, Particle * cpart, int x, int y, int brushX,
 	if(!thisPart)
 		return 0;
 
-	if(random_gen() % 100 != 0)
+	if(sim->rng() % 100 != 0)
 		return 0;
 
 	int distance = (int)(std::pow(strength, .5f) * 10);
@@ -28,8 +28,8 @@ static int perform(Simulation * sim, Particle * cpart, int x, int y, int brushX,
 	if(!(sim->elements[TYP(thisPart)].Properties & (TYPE_PART | TYPE_LIQUID | TYPE_GAS)))
 		return 0;
 
-	int newX = x + (random_gen() % distance) - (distance/2);
-	int newY = y + (random_gen() % distance) - (distance/2);
+	int newX = x + (sim->rng() % distance) - (distance/2);
+	int newY = y + (sim->rng() % distance) - (distance/2);
 
 	if(newX < 0 || newY < 0 || newX >= XRES || newY >= YRES)
 		return 0;
@@ -48,6 +48,10 @@ static int perform(Simulation * sim, Particle * cpart, int x, int y, int brushX,
 	sim->pmap[newY][newX] = thisPart;
 	sim->parts[ID(thisPart)].x = float(newX);
 	sim->parts[ID(thisPart)].y = float(newY);
+	sim->MarkPmapDirty(x, y);
+	sim->MarkPmapDirty(newX, newY);
+	sim->UpdateSubframeOrder(ID(thatPart));
+	sim->UpdateSubframeOrder(ID(thisPart));
 
 	return 1;
 }